@@ -0,0 +1,73 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Allreduce.hpp"
+#include "common/Collectives.hpp"
+#include "common/Environment.hpp"
+#include "common/Reduction.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_allreduce_async(const gaspi_pointer_t buffer_send,
+		gaspi_pointer_t buffer_receive,
+		const gaspi_number_t num,
+		const gaspi_operation_t operation,
+		const gaspi_datatype_t datatype,
+		const gaspi_group_t group)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	if (!Reduction::isValid(operation, datatype)) {
+		fprintf(stderr, "Error: Reduction operation or type is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	if (num == 0)
+		return GASPI_SUCCESS;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	AllreduceOperation *allreduce = new AllreduceOperation(task, group,
+			buffer_send, buffer_receive, num, operation, datatype);
+	assert(allreduce != nullptr);
+
+	// The event is released once the result is in the receive buffer
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	gaspi_return_t eret = Collectives::start(allreduce);
+	if (eret != GASPI_SUCCESS) {
+		TaskingModel::decreaseTaskEvents(task, 1);
+		delete allreduce;
+	}
+
+	return eret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -0,0 +1,129 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Atomics.hpp"
+#include "common/Environment.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+//! \brief Check the arguments of an atomic before accounting its event
+//!
+//! The remote segment cannot be checked locally, so only its identifier
+//! is validated; the rest of errors are fatal once posted
+static gaspi_return_t
+checkAtomic(gaspi_segment_id_t segment, gaspi_offset_t offset, gaspi_rank_t rank)
+{
+	if (offset % sizeof(gaspi_atomic_value_t) != 0) {
+		fprintf(stderr, "Error: Atomic offset is not aligned to %zu bytes\n",
+			sizeof(gaspi_atomic_value_t));
+		return GASPI_ERR_INV_LOC;
+	}
+
+	if (segment >= _env.maxSegments) {
+		fprintf(stderr, "Error: Atomic segment is not valid\n");
+		return GASPI_ERR_INV_SEG;
+	}
+
+	gaspi_rank_t numRanks;
+	gaspi_return_t eret = gaspi_proc_num(&numRanks);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	if (rank >= numRanks) {
+		fprintf(stderr, "Error: Atomic rank is not valid\n");
+		return GASPI_ERR_INV_RANK;
+	}
+
+	return GASPI_SUCCESS;
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_atomic_fetch_add(const gaspi_segment_id_t segment_id,
+		const gaspi_offset_t offset,
+		const gaspi_rank_t rank,
+		const gaspi_atomic_value_t val_add,
+		gaspi_atomic_value_t * const val_old)
+{
+	assert(_env.enabled);
+
+	gaspi_return_t eret = checkAtomic(segment_id, offset, rank);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	Atomics::PendingAtomic atomic;
+	atomic.task = task;
+	atomic.compareSwap = false;
+	atomic.segment = segment_id;
+	atomic.offset = offset;
+	atomic.rank = rank;
+	atomic.value = val_add;
+	atomic.comparator = 0;
+	atomic.oldValue = val_old;
+
+	// The event is released once the old value is stored
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	Atomics::submit(atomic);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_atomic_compare_swap(const gaspi_segment_id_t segment_id,
+		const gaspi_offset_t offset,
+		const gaspi_rank_t rank,
+		const gaspi_atomic_value_t comparator,
+		const gaspi_atomic_value_t val_new,
+		gaspi_atomic_value_t * const val_old)
+{
+	assert(_env.enabled);
+
+	gaspi_return_t eret = checkAtomic(segment_id, offset, rank);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	Atomics::PendingAtomic atomic;
+	atomic.task = task;
+	atomic.compareSwap = true;
+	atomic.segment = segment_id;
+	atomic.offset = offset;
+	atomic.rank = rank;
+	atomic.value = val_new;
+	atomic.comparator = comparator;
+	atomic.oldValue = val_old;
+
+	// The event is released once the old value is stored
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	Atomics::submit(atomic);
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
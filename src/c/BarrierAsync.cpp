@@ -0,0 +1,58 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Barrier.hpp"
+#include "common/Collectives.hpp"
+#include "common/Environment.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_barrier_async(const gaspi_group_t group)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	BarrierOperation *barrier = new BarrierOperation(task, group);
+	assert(barrier != nullptr);
+
+	// The event is released once the barrier finishes
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	gaspi_return_t eret = Collectives::start(barrier);
+	if (eret != GASPI_SUCCESS) {
+		TaskingModel::decreaseTaskEvents(task, 1);
+		delete barrier;
+	}
+
+	return eret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
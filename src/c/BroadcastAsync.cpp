@@ -0,0 +1,93 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Broadcast.hpp"
+#include "common/Collectives.hpp"
+#include "common/Environment.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+using namespace tagaspi;
+
+//! \brief Check that the root is a member of the group
+static gaspi_return_t
+checkRoot(gaspi_rank_t root, gaspi_group_t group)
+{
+	gaspi_number_t size;
+	gaspi_return_t eret = gaspi_group_size(group, &size);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	std::vector<gaspi_rank_t> ranks(size);
+	eret = gaspi_group_ranks(group, ranks.data());
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	if (std::find(ranks.begin(), ranks.end(), root) == ranks.end()) {
+		fprintf(stderr, "Error: Root %d of broadcast is not a member of group %d\n", (int) root, (int) group);
+		return GASPI_ERR_INV_RANK;
+	}
+
+	return GASPI_SUCCESS;
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_bcast_async(gaspi_pointer_t buffer,
+		const gaspi_size_t size,
+		const gaspi_rank_t root,
+		const gaspi_group_t group)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	if (size == 0)
+		return GASPI_SUCCESS;
+
+	// The root is checked here, since the operation progresses asynchronously
+	gaspi_return_t eret = checkRoot(root, group);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	BroadcastOperation *bcast = new BroadcastOperation(task, group, buffer, size, root);
+	assert(bcast != nullptr);
+
+	// The event is released once the data is in the buffer and forwarded
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	eret = Collectives::start(bcast);
+	if (eret != GASPI_SUCCESS) {
+		TaskingModel::decreaseTaskEvents(task, 1);
+		delete bcast;
+	}
+
+	return eret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
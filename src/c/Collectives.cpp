@@ -0,0 +1,55 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Collectives.hpp"
+#include "common/Environment.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_collectives_enable(const gaspi_segment_id_t segment_id,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	if (Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are already enabled\n");
+		return GASPI_ERROR;
+	}
+
+	return Collectives::enable(segment_id, queue);
+}
+
+gaspi_return_t
+tagaspi_collectives_disable(void)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	return Collectives::disable();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -0,0 +1,127 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Completion.hpp"
+#include "common/Detached.hpp"
+#include "common/Environment.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+
+using namespace tagaspi;
+
+//! \brief Submit a detached operation on the open epoch of its queue
+static gaspi_return_t
+submitDetached(gaspi_operation_type_t type,
+		Operation operation,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue)
+{
+	gaspi_number_t numRequests = _env.numRequests[operation];
+	assert(numRequests > 0);
+
+	Completion *epoch = Detached::acquire(queue, numRequests);
+	assert(epoch != nullptr);
+
+	gaspi_return_t eret = gaspi_operation_submit(type, epoch->getTag(),
+				segmentLocal, offsetLocal, rank,
+				segmentRemote, offsetRemote, size,
+				notificationId, notificationValue,
+				queue, GASPI_BLOCK);
+	assert(eret != GASPI_TIMEOUT);
+
+	if (eret != GASPI_SUCCESS) {
+		epoch->decrease(numRequests);
+	}
+
+	return eret;
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_write_detached(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	return submitDetached(GASPI_OP_WRITE, Operation::WRITE,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			0, 0, queue);
+}
+
+gaspi_return_t
+tagaspi_notify_detached(const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	return submitDetached(GASPI_OP_NOTIFY, Operation::NOTIFY,
+			0, 0, rank, segment_id_remote, 0, 0,
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_write_notify_detached(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	return submitDetached(GASPI_OP_WRITE_NOTIFY, Operation::WRITE_NOTIFY,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_fence_async(const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	Detached::fence(task, queue);
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
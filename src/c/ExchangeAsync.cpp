@@ -0,0 +1,139 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Collectives.hpp"
+#include "common/Environment.hpp"
+#include "common/Exchange.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using namespace tagaspi;
+
+//! \brief Start an exchange on behalf of the current task
+static gaspi_return_t
+startExchange(gaspi_group_t group,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_notification_t notificationValue,
+		bool byMember,
+		std::vector<ExchangeOperation::Block> &&blocks)
+{
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	ExchangeOperation *exchange = new ExchangeOperation(task, group,
+			segmentLocal, segmentRemote, notificationValue,
+			byMember, std::move(blocks));
+	assert(exchange != nullptr);
+
+	// The event is released once all local writes have completed
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	gaspi_return_t eret = Collectives::start(exchange);
+	if (eret != GASPI_SUCCESS) {
+		TaskingModel::decreaseTaskEvents(task, 1);
+		delete exchange;
+	}
+
+	return eret;
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_alltoallv_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offsets_local[],
+		const gaspi_size_t sizes[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_notification_id_t notification_begin,
+		const gaspi_notification_t notification_value,
+		const gaspi_group_t group)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	if (notification_value == 0) {
+		fprintf(stderr, "Error: Notification value cannot be zero\n");
+		return GASPI_ERROR;
+	}
+
+	gaspi_number_t size;
+	gaspi_return_t eret = gaspi_group_size(group, &size);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	// The block of this rank lands on the notification begin plus its position
+	std::vector<ExchangeOperation::Block> blocks(size);
+	for (gaspi_number_t m = 0; m < size; ++m) {
+		blocks[m].peer = m;
+		blocks[m].offsetLocal = offsets_local[m];
+		blocks[m].offsetRemote = offsets_remote[m];
+		blocks[m].size = sizes[m];
+		blocks[m].notificationId = notification_begin;
+	}
+
+	return startExchange(group, segment_id_local, segment_id_remote,
+			notification_value, true, std::move(blocks));
+}
+
+gaspi_return_t
+tagaspi_neighbor_exchange_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_number_t num_neighbors,
+		const gaspi_rank_t neighbors[],
+		const gaspi_offset_t offsets_local[],
+		const gaspi_size_t sizes[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_notification_id_t notification_ids[],
+		const gaspi_notification_t notification_value,
+		const gaspi_group_t group)
+{
+	assert(_env.enabled);
+
+	if (!Collectives::isEnabled()) {
+		fprintf(stderr, "Error: Collectives are not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	if (notification_value == 0) {
+		fprintf(stderr, "Error: Notification value cannot be zero\n");
+		return GASPI_ERROR;
+	}
+
+	std::vector<ExchangeOperation::Block> blocks(num_neighbors);
+	for (gaspi_number_t n = 0; n < num_neighbors; ++n) {
+		blocks[n].peer = neighbors[n];
+		blocks[n].offsetLocal = offsets_local[n];
+		blocks[n].offsetRemote = offsets_remote[n];
+		blocks[n].size = sizes[n];
+		blocks[n].notificationId = notification_ids[n];
+	}
+
+	return startExchange(group, segment_id_local, segment_id_remote,
+			notification_value, false, std::move(blocks));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
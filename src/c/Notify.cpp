@@ -8,6 +8,7 @@
 #include <GASPI_Lowlevel.h>
 
 #include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
 #include "common/TaskingModel.hpp"
 
 #include <cassert>
@@ -40,11 +41,18 @@ tagaspi_notify(const gaspi_segment_id_t segment_id_remote,
 
 	TaskingModel::increaseCurrentTaskEvents(task, numRequests);
 
-	eret = gaspi_operation_submit(GASPI_OP_NOTIFY, tag,
-				0, 0, rank, segment_id_remote, 0, 0,
-				notification_id, notification_value,
-				queue, GASPI_BLOCK);
-	assert(eret != GASPI_TIMEOUT);
+	if (FlowControl::isEnabled()) {
+		eret = FlowControl::submit(tag, numRequests, GASPI_OP_NOTIFY,
+					0, 0, rank, segment_id_remote, 0, 0,
+					notification_id, notification_value,
+					queue);
+	} else {
+		eret = gaspi_operation_submit(GASPI_OP_NOTIFY, tag,
+					0, 0, rank, segment_id_remote, 0, 0,
+					notification_id, notification_value,
+					queue, GASPI_BLOCK);
+		assert(eret != GASPI_TIMEOUT);
+	}
 
 	if (eret != GASPI_SUCCESS) {
 		TaskingModel::decreaseTaskEvents(task, numRequests);
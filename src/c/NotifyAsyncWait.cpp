@@ -6,6 +6,7 @@
 
 #include <GASPI.h>
 #include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
 
 #include "common/Allocator.hpp"
 #include "common/Environment.hpp"
@@ -14,6 +15,7 @@
 #include "common/WaitingRangeQueue.hpp"
 
 #include <cassert>
+#include <cstdio>
 
 using namespace tagaspi;
 
@@ -89,6 +91,42 @@ tagaspi_notify_async_waitall(const gaspi_segment_id_t segment_id,
 	return GASPI_SUCCESS;
 }
 
+gaspi_return_t
+tagaspi_notify_wait_callback(const gaspi_segment_id_t segment_id,
+		const gaspi_notification_id_t notification_id,
+		gaspi_notification_t *notification_value,
+		tagaspi_callback_t callback,
+		void *args,
+		int * const flag)
+{
+	assert(_env.enabled);
+	assert(segment_id < _env.maxSegments);
+
+	if (callback == nullptr || flag == nullptr) {
+		fprintf(stderr, "Error: Callback is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	gaspi_number_t remaining = WaitingRange::checkNotification(
+		segment_id, notification_id, notification_value);
+
+	*flag = (remaining == 0);
+	if (*flag)
+		return GASPI_SUCCESS;
+
+	// The callback runs from the polling instance once notified
+	WaitingRange *waitingRange =
+		Allocator<WaitingRange>::allocate(
+			segment_id, notification_id, 1,
+			notification_value, 1, nullptr,
+			callback, args, true);
+	assert(waitingRange != nullptr);
+
+	_env.waitingRangeQueues[segment_id].enqueue(waitingRange);
+
+	return GASPI_SUCCESS;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,163 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Allocator.hpp"
+#include "common/Environment.hpp"
+#include "common/Packing.hpp"
+#include "common/StridedList.hpp"
+#include "common/TaskingModel.hpp"
+#include "common/WaitingRange.hpp"
+#include "common/WaitingRangeQueue.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_write_strided_packed_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_segment_id_t segment_id_staging,
+		const gaspi_offset_t offset_staging_local,
+		const gaspi_offset_t offset_staging_remote,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	if (dims == 0 || counts == nullptr || (dims > 1 && (strides_local == nullptr || strides_remote == nullptr))) {
+		fprintf(stderr, "Error: Invalid dimensions of strided transfer\n");
+		return GASPI_ERROR;
+	}
+
+	if (StridedList::isEmpty(dims, counts))
+		return tagaspi_notify(segment_id_staging, rank,
+				notification_id, notification_value, queue);
+
+	// Large blocks are written directly to their destination
+	if (!Packing::mustPack(strides_remote, dims, counts)) {
+		OperationList list = StridedList::get(
+			segment_id_local, offset_local, strides_local,
+			segment_id_remote, offset_remote, strides_remote,
+			dims, counts);
+
+		return tagaspi_write_list_notify(list.num, list.segmentLocal, list.offsetLocal, rank,
+				list.segmentRemote, list.offsetRemote, list.size,
+				segment_id_staging, notification_id, notification_value,
+				queue);
+	}
+
+	gaspi_pointer_t local, staging;
+	gaspi_return_t eret = gaspi_segment_ptr(segment_id_local, &local);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	eret = gaspi_segment_ptr(segment_id_staging, &staging);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	Packing::pack((char *) staging + offset_staging_local,
+		(const char *) local + offset_local,
+		strides_local, dims, counts);
+
+	return tagaspi_write_notify(segment_id_staging, offset_staging_local, rank,
+			segment_id_staging, offset_staging_remote, Packing::getSize(dims, counts),
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_unpack_strided_async(const gaspi_segment_id_t segment_id_staging,
+		const gaspi_offset_t offset_staging,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_notification_id_t notification_id,
+		gaspi_notification_t *notification_value)
+{
+	assert(_env.enabled);
+	assert(segment_id_staging < _env.maxSegments);
+
+	if (dims == 0 || counts == nullptr || (dims > 1 && strides_local == nullptr)) {
+		fprintf(stderr, "Error: Invalid dimensions of strided transfer\n");
+		return GASPI_ERROR;
+	}
+
+	// The sender takes the same decision based on this layout
+	if (StridedList::isEmpty(dims, counts) || !Packing::mustPack(strides_local, dims, counts))
+		return tagaspi_notify_async_wait(segment_id_staging, notification_id, notification_value);
+
+	gaspi_pointer_t local, staging;
+	gaspi_return_t eret = gaspi_segment_ptr(segment_id_local, &local);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	eret = gaspi_segment_ptr(segment_id_staging, &staging);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_number_t remaining = WaitingRange::checkNotification(
+		segment_id_staging, notification_id, notification_value);
+
+	if (remaining == 0) {
+		Packing::unpack((char *) local + offset_local,
+			(const char *) staging + offset_staging,
+			strides_local, dims, counts);
+		return GASPI_SUCCESS;
+	}
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	Packing::UnpackArgs *args = new Packing::UnpackArgs();
+	assert(args != nullptr);
+
+	args->task = task;
+	args->staging = (const char *) staging + offset_staging;
+	args->target = (char *) local + offset_local;
+	args->counts.assign(counts, counts + dims);
+	if (dims > 1)
+		args->strides.assign(strides_local, strides_local + dims - 1);
+
+	// The notification spawns a task that unpacks the region
+	WaitingRange *waitingRange =
+		Allocator<WaitingRange>::allocate(
+			segment_id_staging, notification_id, 1,
+			notification_value, 1, task,
+			Packing::unpackTask, args);
+	assert(waitingRange != nullptr);
+
+	_env.waitingRangeQueues[segment_id_staging].enqueue(waitingRange);
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
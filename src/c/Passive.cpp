@@ -0,0 +1,82 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#include "common/Environment.hpp"
+#include "common/Passive.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_passive_send_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_size_t size)
+{
+	assert(_env.enabled);
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	Passive::PendingPassive operation;
+	operation.task = task;
+	operation.segment = segment_id_local;
+	operation.offset = offset_local;
+	operation.size = size;
+	operation.rank = rank;
+	operation.sourceRank = nullptr;
+
+	// The event is released once the buffer can be reused
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	Passive::send(operation);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_passive_receive_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		gaspi_rank_t * const rem_rank,
+		const gaspi_size_t size)
+{
+	assert(_env.enabled);
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	Passive::PendingPassive operation;
+	operation.task = task;
+	operation.segment = segment_id_local;
+	operation.offset = offset_local;
+	operation.size = size;
+	operation.rank = 0;
+	operation.sourceRank = rem_rank;
+
+	// The event is released once the message and its source are stored
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	Passive::receive(operation);
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
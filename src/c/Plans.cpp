@@ -0,0 +1,215 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Environment.hpp"
+#include "common/OperationList.hpp"
+#include "common/Plan.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+static inline Plan *
+getPlan(tagaspi_plan_t plan)
+{
+	return reinterpret_cast<Plan *>(plan);
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_plan_create(tagaspi_plan_t * const plan)
+{
+	assert(_env.enabled);
+
+	if (plan == nullptr) {
+		fprintf(stderr, "Error: Plan handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	Plan *newPlan = new Plan();
+	assert(newPlan != nullptr);
+
+	*plan = reinterpret_cast<tagaspi_plan_t>(newPlan);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_plan_free(tagaspi_plan_t plan)
+{
+	if (plan == nullptr) {
+		fprintf(stderr, "Error: Plan handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	delete getPlan(plan);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_plan_add_write(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	return getPlan(plan)->add(GASPI_OP_WRITE,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			0, 0, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_read(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	return getPlan(plan)->add(GASPI_OP_READ,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			0, 0, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_notify(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	return getPlan(plan)->add(GASPI_OP_NOTIFY,
+			0, 0, rank, segment_id_remote, 0, 0,
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_write_notify(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	return getPlan(plan)->add(GASPI_OP_WRITE_NOTIFY,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_write_list(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	OperationList list(num, segment_id_local, offset_local,
+				segment_id_remote, offset_remote, size);
+
+	return getPlan(plan)->addList(GASPI_OP_WRITE_LIST,
+			list, rank, 0, 0, 0, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_read_list(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	OperationList list(num, segment_id_local, offset_local,
+				segment_id_remote, offset_remote, size);
+
+	return getPlan(plan)->addList(GASPI_OP_READ_LIST,
+			list, rank, 0, 0, 0, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_add_write_list_notify(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_segment_id_t segment_id_notification,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(plan != nullptr);
+
+	OperationList list(num, segment_id_local, offset_local,
+				segment_id_remote, offset_remote, size);
+
+	return getPlan(plan)->addList(GASPI_OP_WRITE_LIST_NOTIFY,
+			list, rank, segment_id_notification,
+			notification_id, notification_value, queue);
+}
+
+gaspi_return_t
+tagaspi_plan_start(tagaspi_plan_t plan)
+{
+	assert(_env.enabled);
+	assert(plan != nullptr);
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	return getPlan(plan)->start(task);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -8,16 +8,58 @@
 #include <TAGASPI.h>
 
 #include "common/Environment.hpp"
+#include "common/Polling.hpp"
 #include "common/QueueGroup.hpp"
 #include "common/TaskingModel.hpp"
-#include "common/util/SpinLock.hpp"
+#include "common/util/RCU.hpp"
+#include "common/util/Utils.hpp"
 
 #include <cassert>
 #include <cstdio>
-#include <mutex>
+#include <vector>
 
 using namespace tagaspi;
 
+static gaspi_return_t
+createQueueGroup(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_queue_id_t queue_begin,
+			const gaspi_number_t latency_queue_num,
+			const gaspi_number_t bulk_queue_num,
+			const gaspi_size_t size_threshold,
+			const gaspi_queue_group_policy_t policy)
+{
+	assert(queue_group_id < _env.maxQueueGroups);
+	assert(queue_begin < _env.maxQueues);
+	assert(queue_begin + latency_queue_num + bulk_queue_num <= _env.maxQueues);
+	assert(latency_queue_num > 0);
+
+	if (!QueueGroup::isValidPolicy(policy)) {
+		fprintf(stderr, "Error: Queue group policy is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	QueueGroup *queueGroup = new QueueGroup(queue_begin, latency_queue_num);
+	assert(queueGroup != nullptr);
+
+	queueGroup->setupPolicy(policy);
+
+	if (bulk_queue_num > 0) {
+		QueueGroup *bulkGroup = new QueueGroup(queue_begin + latency_queue_num, bulk_queue_num);
+		assert(bulkGroup != nullptr);
+
+		bulkGroup->setupPolicy(policy);
+		queueGroup->setBulkSubgroup(bulkGroup, size_threshold);
+	}
+
+	if (!_env.queueGroups.insert(queue_group_id, queueGroup)) {
+		fprintf(stderr, "Error: Queue group %d already exists\n", queue_group_id);
+		delete queueGroup;
+		return GASPI_ERROR;
+	}
+
+	return GASPI_SUCCESS;
+}
+
 #pragma GCC visibility push(default)
 
 #ifdef __cplusplus
@@ -30,35 +72,68 @@ tagaspi_queue_group_create(const gaspi_queue_group_id_t queue_group_id,
 			const gaspi_number_t queue_num,
 			const gaspi_queue_group_policy_t policy)
 {
-	assert(queue_group_id < _env.maxQueueGroups);
-	assert(queue_begin < _env.maxQueues);
-	assert(queue_begin + queue_num <= _env.maxQueues);
 	assert(queue_num > 0);
 
-	std::lock_guard<SpinLock> guard(_env.queueGroupsLock);
+	return createQueueGroup(queue_group_id, queue_begin, queue_num, 0, 0, policy);
+}
 
-	if (_env.numQueueGroups >= _env.maxQueueGroups) {
-		fprintf(stderr, "Error: Too many queue groups created\n");
-		return GASPI_ERROR;
-	}
+gaspi_return_t
+tagaspi_queue_group_create_split(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_queue_id_t queue_begin,
+			const gaspi_number_t latency_queue_num,
+			const gaspi_number_t bulk_queue_num,
+			const gaspi_size_t size_threshold,
+			const gaspi_queue_group_policy_t policy)
+{
+	assert(latency_queue_num > 0);
+	assert(bulk_queue_num > 0);
 
-	if (_env.queueGroups[queue_group_id] != nullptr) {
-		fprintf(stderr, "Error: Queue group %d already exists\n", queue_group_id);
+	return createQueueGroup(queue_group_id, queue_begin, latency_queue_num,
+		bulk_queue_num, size_threshold, policy);
+}
+
+gaspi_return_t
+tagaspi_queue_group_create_elastic(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_number_t min_queue_num,
+			const gaspi_number_t max_queue_num,
+			const gaspi_queue_group_policy_t policy)
+{
+	assert(queue_group_id < _env.maxQueueGroups);
+	assert(min_queue_num > 0);
+	assert(min_queue_num <= max_queue_num);
+	assert(max_queue_num <= _env.maxQueues);
+
+	if (policy != GASPI_QUEUE_GROUP_POLICY_DEFAULT) {
+		fprintf(stderr, "Error: Elastic queue groups only support the default policy\n");
 		return GASPI_ERROR;
 	}
 
-	if (!QueueGroup::isValidPolicy(policy)) {
-		fprintf(stderr, "Error: Queue group policy is not valid\n");
-		return GASPI_ERROR;
+	std::vector<gaspi_queue_id_t> queues(min_queue_num);
+	for (gaspi_number_t q = 0; q < min_queue_num; ++q) {
+		gaspi_return_t eret = gaspi_queue_create(&queues[q], GASPI_BLOCK);
+		if (eret != GASPI_SUCCESS) {
+			fprintf(stderr, "Error: Return code %d from gaspi_queue_create\n", eret);
+			while (q-- > 0) {
+				gaspi_queue_delete(queues[q]);
+			}
+			return eret;
+		}
 	}
 
-	QueueGroup *queueGroup = new QueueGroup(queue_begin, queue_num);
+	// The group deletes its queues when released
+	QueueGroup *queueGroup = new QueueGroup(queues, max_queue_num);
 	assert(queueGroup != nullptr);
 
 	queueGroup->setupPolicy(policy);
 
-	_env.queueGroups[queue_group_id] = queueGroup;
-	_env.numQueueGroups += 1;
+	if (!_env.queueGroups.insert(queue_group_id, queueGroup)) {
+		fprintf(stderr, "Error: Queue group %d already exists\n", queue_group_id);
+		delete queueGroup;
+		return GASPI_ERROR;
+	}
+
+	// The queues of elastic groups are adjusted periodically
+	Polling::enableQueueGroupsPolling();
 
 	return GASPI_SUCCESS;
 }
@@ -68,17 +143,29 @@ tagaspi_queue_group_delete(const gaspi_queue_group_id_t queue_group_id)
 {
 	assert(queue_group_id < _env.maxQueueGroups);
 
-	std::lock_guard<SpinLock> guard(_env.queueGroupsLock);
-
-	QueueGroup *queueGroup = _env.queueGroups[queue_group_id];
+	QueueGroup *queueGroup = _env.queueGroups.remove(queue_group_id);
 	if (queueGroup == nullptr) {
 		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group_id);
 		return GASPI_ERROR;
 	}
-	delete queueGroup;
 
-	_env.queueGroups[queue_group_id] = nullptr;
-	_env.numQueueGroups -= 1;
+	// Wait for the concurrent lookups that may still use the group
+	util::RCU::synchronize();
+
+	// Complete the requests in flight on the queues that are deleted with
+	// the group, so that their tasks get their events released
+	const gaspi_number_t numCreated = queueGroup->getNumCreatedQueues();
+	for (gaspi_number_t q = 0; q < numCreated; ++q) {
+		const gaspi_queue_id_t queue = queueGroup->getQueueAt(q);
+
+		gaspi_number_t size;
+		while (gaspi_queue_size(queue, &size) == GASPI_SUCCESS && size > 0) {
+			Polling::pollQueue(queue);
+			util::spinWait();
+		}
+	}
+
+	delete queueGroup;
 
 	return GASPI_SUCCESS;
 }
@@ -90,16 +177,89 @@ tagaspi_queue_group_get_queue(const gaspi_queue_group_id_t queue_group_id,
 	assert(queue_group_id < _env.maxQueueGroups);
 	assert(queue != NULL);
 
-	QueueGroup *queueGroup = _env.queueGroups[queue_group_id];
+	util::RCUReadGuard guard;
+
+	QueueGroup *queueGroup = _env.queueGroups.get(queue_group_id);
 	if (queueGroup == nullptr) {
 		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group_id);
 		return GASPI_ERROR;
 	}
+
+	if (queueGroup->requiresRank()) {
+		fprintf(stderr, "Error: Queue group %d requires the destination rank\n", queue_group_id);
+		return GASPI_ERROR;
+	}
 	*queue = queueGroup->getQueue();
 
 	return GASPI_SUCCESS;
 }
 
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_rank(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_rank_t rank,
+			gaspi_queue_id_t * const queue)
+{
+	assert(queue_group_id < _env.maxQueueGroups);
+	assert(queue != NULL);
+
+	util::RCUReadGuard guard;
+
+	QueueGroup *queueGroup = _env.queueGroups.get(queue_group_id);
+	if (queueGroup == nullptr) {
+		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group_id);
+		return GASPI_ERROR;
+	}
+	*queue = queueGroup->getQueue(rank);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_size(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_size_t size,
+			gaspi_queue_id_t * const queue)
+{
+	assert(queue_group_id < _env.maxQueueGroups);
+	assert(queue != NULL);
+
+	util::RCUReadGuard guard;
+
+	QueueGroup *queueGroup = _env.queueGroups.get(queue_group_id);
+	if (queueGroup == nullptr) {
+		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group_id);
+		return GASPI_ERROR;
+	}
+
+	if (queueGroup->requiresRank()) {
+		fprintf(stderr, "Error: Queue group %d requires the destination rank\n", queue_group_id);
+		return GASPI_ERROR;
+	}
+	*queue = queueGroup->getQueueForSize(size);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_rank_and_size(const gaspi_queue_group_id_t queue_group_id,
+			const gaspi_rank_t rank,
+			const gaspi_size_t size,
+			gaspi_queue_id_t * const queue)
+{
+	assert(queue_group_id < _env.maxQueueGroups);
+	assert(queue != NULL);
+
+	util::RCUReadGuard guard;
+
+	QueueGroup *queueGroup = _env.queueGroups.get(queue_group_id);
+	if (queueGroup == nullptr) {
+		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group_id);
+		return GASPI_ERROR;
+	}
+	*queue = queueGroup->getQueue(rank, size);
+
+	return GASPI_SUCCESS;
+}
+
 gaspi_return_t
 tagaspi_queue_group_max(gaspi_number_t * const queue_group_max)
 {
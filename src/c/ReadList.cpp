@@ -8,6 +8,9 @@
 #include <GASPI_Lowlevel.h>
 
 #include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
+#include "common/OperationList.hpp"
+#include "common/SplitList.hpp"
 #include "common/TaskingModel.hpp"
 
 #include <cassert>
@@ -38,18 +41,37 @@ tagaspi_read_list(const gaspi_number_t num,
 
 	gaspi_tag_t tag = (gaspi_tag_t) task;
 
+	OperationList list(num, segment_id_local, offset_local,
+				segment_id_remote, offset_remote, size);
+
+	// Merge the entries that are contiguous locally and remotely
+	if (_env.listCoalescing)
+		list.coalesce();
+
 	gaspi_number_t numRequests = 0;
-	eret = gaspi_operation_get_num_requests(GASPI_OP_READ_LIST, num, &numRequests);
+	eret = gaspi_operation_get_num_requests(GASPI_OP_READ_LIST, list.num, &numRequests);
 	assert(eret == GASPI_SUCCESS);
 	assert(numRequests > 0);
 
+	// Split the lists that do not fit in the free space of the queue
+	if (SplitList::mustSplit(numRequests, queue))
+		return SplitList::submit(task, GASPI_OP_READ_LIST, list, rank,
+				0, 0, 0, queue);
+
 	TaskingModel::increaseCurrentTaskEvents(task, numRequests);
 
-	eret = gaspi_operation_list_submit(GASPI_OP_READ_LIST, tag,
-				num, segment_id_local, offset_local, rank,
-				segment_id_remote, offset_remote, size,
-				0, 0, 0, queue, GASPI_BLOCK);
-	assert(eret != GASPI_TIMEOUT);
+	if (FlowControl::isEnabled()) {
+		eret = FlowControl::submitList(tag, numRequests, GASPI_OP_READ_LIST,
+					list.num, list.segmentLocal, list.offsetLocal, rank,
+					list.segmentRemote, list.offsetRemote, list.size,
+					0, 0, 0, queue);
+	} else {
+		eret = gaspi_operation_list_submit(GASPI_OP_READ_LIST, tag,
+					list.num, list.segmentLocal, list.offsetLocal, rank,
+					list.segmentRemote, list.offsetRemote, list.size,
+					0, 0, 0, queue, GASPI_BLOCK);
+		assert(eret != GASPI_TIMEOUT);
+	}
 
 	if (eret != GASPI_SUCCESS) {
 		TaskingModel::decreaseTaskEvents(task, numRequests);
@@ -0,0 +1,97 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "common/ChunkedCompletion.hpp"
+#include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
+#include "common/OperationList.hpp"
+#include "common/SplitList.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_read_list_notify(const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_segment_id_t segment_id_notification,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+	gaspi_return_t eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	OperationList list(num, segment_id_local, offset_local,
+				segment_id_remote, offset_remote, size);
+
+	// Merge the entries that are contiguous locally and remotely
+	if (_env.listCoalescing)
+		list.coalesce();
+
+	gaspi_number_t numRequests = 0;
+	eret = gaspi_operation_get_num_requests(GASPI_OP_READ_LIST, list.num, &numRequests);
+	assert(eret == GASPI_SUCCESS);
+	assert(numRequests > 0);
+
+	// Split the lists that do not fit in the free space of the queue
+	if (SplitList::mustSplit(numRequests, queue))
+		return SplitList::submit(task, GASPI_OP_READ_LIST_NOTIFY, list, rank,
+				segment_id_notification, notification_id,
+				1, queue);
+
+	// A single event for the list plus the requests of the notification
+	TaskingModel::increaseCurrentTaskEvents(task, 1 + _env.numRequests[Operation::NOTIFY]);
+
+	// The owner of the data is notified with value 1 once it has been read
+	ChunkedCompletion *completion = new ChunkedCompletion(numRequests, task, true,
+		segment_id_notification, rank, notification_id, 1, queue);
+	assert(completion != nullptr);
+
+	if (FlowControl::isEnabled()) {
+		eret = FlowControl::submitList(completion->getTag(), numRequests, GASPI_OP_READ_LIST,
+					list.num, list.segmentLocal, list.offsetLocal, rank,
+					list.segmentRemote, list.offsetRemote, list.size,
+					0, 0, 0, queue);
+	} else {
+		eret = gaspi_operation_list_submit(GASPI_OP_READ_LIST,
+					completion->getTag(), list.num, list.segmentLocal, list.offsetLocal, rank,
+					list.segmentRemote, list.offsetRemote, list.size,
+					0, 0, 0, queue, GASPI_BLOCK);
+		assert(eret != GASPI_TIMEOUT);
+	}
+
+	if (eret != GASPI_SUCCESS) {
+		// Releases the events without notifying the owner
+		completion->fail();
+		completion->decrease(numRequests);
+	}
+
+	return eret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
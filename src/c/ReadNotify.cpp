@@ -0,0 +1,78 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "common/ChunkedCompletion.hpp"
+#include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_read_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+	gaspi_return_t eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	gaspi_number_t numRequests = _env.numRequests[Operation::READ];
+	assert(numRequests > 0);
+
+	// A single event for the read plus the requests of the notification
+	TaskingModel::increaseCurrentTaskEvents(task, 1 + _env.numRequests[Operation::NOTIFY]);
+
+	// The owner of the data is notified with value 1 once it has been read
+	ChunkedCompletion *completion = new ChunkedCompletion(numRequests, task, true,
+		segment_id_remote, rank, notification_id, 1, queue);
+	assert(completion != nullptr);
+
+	if (FlowControl::isEnabled()) {
+		eret = FlowControl::submit(completion->getTag(), numRequests, GASPI_OP_READ,
+					segment_id_local, offset_local, rank,
+					segment_id_remote, offset_remote, size,
+					0, 0, queue);
+	} else {
+		eret = gaspi_operation_submit(GASPI_OP_READ, completion->getTag(),
+					segment_id_local, offset_local, rank,
+					segment_id_remote, offset_remote, size,
+					0, 0, queue, GASPI_BLOCK);
+		assert(eret != GASPI_TIMEOUT);
+	}
+
+	if (eret != GASPI_SUCCESS) {
+		// Releases the events without notifying the owner
+		completion->fail();
+		completion->decrease(numRequests);
+	}
+
+	return eret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -0,0 +1,44 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Striping.hpp"
+
+#include <cassert>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_read_striped(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_group_id_t queue_group)
+{
+	assert(_env.enabled);
+
+	return Striping::submit(GASPI_OP_READ,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			false, 0, 0, queue_group);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
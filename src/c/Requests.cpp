@@ -0,0 +1,275 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/DeferredRequests.hpp"
+#include "common/Environment.hpp"
+#include "common/Request.hpp"
+#include "common/TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+static inline Request *
+getRequest(tagaspi_request_t request)
+{
+	return reinterpret_cast<Request *>(request);
+}
+
+//! \brief Submit an operation whose completion is followed by a request
+static gaspi_return_t
+submitRequest(gaspi_operation_type_t type,
+		Operation operation,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue,
+		tagaspi_request_t *request)
+{
+	if (request == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	gaspi_number_t numRequests = _env.numRequests[operation];
+	assert(numRequests > 0);
+
+	Request *newRequest = new Request(numRequests);
+	assert(newRequest != nullptr);
+
+	DeferredRequests::PendingRequest pending;
+	pending.type = type;
+	pending.tag = newRequest->getTag();
+	pending.segmentLocal = segmentLocal;
+	pending.offsetLocal = offsetLocal;
+	pending.rank = rank;
+	pending.segmentRemote = segmentRemote;
+	pending.offsetRemote = offsetRemote;
+	pending.size = size;
+	pending.notificationId = notificationId;
+	pending.notificationValue = notificationValue;
+	pending.queue = queue;
+
+	// Never wait for queue space, since this may run from the polling
+	gaspi_return_t eret = DeferredRequests::submit(pending);
+
+	if (eret != GASPI_SUCCESS) {
+		// Nobody else references the request yet
+		newRequest->decrease(numRequests);
+		newRequest->test();
+		*request = TAGASPI_REQUEST_NULL;
+		return eret;
+	}
+
+	*request = reinterpret_cast<tagaspi_request_t>(newRequest);
+
+	return GASPI_SUCCESS;
+}
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_write_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request)
+{
+	assert(_env.enabled);
+
+	return submitRequest(GASPI_OP_WRITE, Operation::WRITE,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			0, 0, queue, request);
+}
+
+gaspi_return_t
+tagaspi_read_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request)
+{
+	assert(_env.enabled);
+
+	return submitRequest(GASPI_OP_READ, Operation::READ,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			0, 0, queue, request);
+}
+
+gaspi_return_t
+tagaspi_notify_request(const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request)
+{
+	assert(_env.enabled);
+
+	return submitRequest(GASPI_OP_NOTIFY, Operation::NOTIFY,
+			0, 0, rank, segment_id_remote, 0, 0,
+			notification_id, notification_value,
+			queue, request);
+}
+
+gaspi_return_t
+tagaspi_write_notify_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request)
+{
+	assert(_env.enabled);
+
+	return submitRequest(GASPI_OP_WRITE_NOTIFY, Operation::WRITE_NOTIFY,
+			segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			notification_id, notification_value,
+			queue, request);
+}
+
+gaspi_return_t
+tagaspi_request_test(tagaspi_request_t * const request, int * const flag)
+{
+	if (request == nullptr || flag == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	if (*request == TAGASPI_REQUEST_NULL) {
+		*flag = 1;
+		return GASPI_SUCCESS;
+	}
+
+	*flag = getRequest(*request)->test();
+	if (*flag)
+		*request = TAGASPI_REQUEST_NULL;
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_request_wait_async(tagaspi_request_t * const request)
+{
+	if (request == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	if (*request == TAGASPI_REQUEST_NULL)
+		return GASPI_SUCCESS;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	getRequest(*request)->bind(task);
+	*request = TAGASPI_REQUEST_NULL;
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_request_waitall_async(const gaspi_number_t num,
+		tagaspi_request_t * const requests)
+{
+	if (num > 0 && requests == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	for (gaspi_number_t r = 0; r < num; ++r) {
+		gaspi_return_t eret = tagaspi_request_wait_async(&requests[r]);
+		if (eret != GASPI_SUCCESS)
+			return eret;
+	}
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_request_wait_callback(tagaspi_request_t * const request,
+		tagaspi_callback_t callback,
+		void *args,
+		int * const flag)
+{
+	if (request == nullptr || callback == nullptr || flag == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	if (*request == TAGASPI_REQUEST_NULL) {
+		*flag = 1;
+		return GASPI_SUCCESS;
+	}
+
+	*flag = !getRequest(*request)->bind(callback, args);
+	*request = TAGASPI_REQUEST_NULL;
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_request_create(tagaspi_request_t * const request)
+{
+	if (request == nullptr) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	// The request completes once its owner discounts this request
+	Request *newRequest = new Request(1);
+	assert(newRequest != nullptr);
+
+	*request = reinterpret_cast<tagaspi_request_t>(newRequest);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t
+tagaspi_request_complete(tagaspi_request_t request)
+{
+	if (request == TAGASPI_REQUEST_NULL) {
+		fprintf(stderr, "Error: Request handle is not valid\n");
+		return GASPI_ERROR;
+	}
+
+	getRequest(request)->decrease(1);
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -8,6 +8,7 @@
 #include <GASPI_Lowlevel.h>
 
 #include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
 #include "common/TaskingModel.hpp"
 
 #include <cassert>
@@ -44,12 +45,20 @@ tagaspi_write_notify(const gaspi_segment_id_t segment_id_local,
 
 	TaskingModel::increaseCurrentTaskEvents(task, numRequests);
 
-	eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY, tag,
-				segment_id_local, offset_local, rank,
-				segment_id_remote, offset_remote, size,
-				notification_id, notification_value,
-				queue, GASPI_BLOCK);
-	assert(eret != GASPI_TIMEOUT);
+	if (FlowControl::isEnabled()) {
+		eret = FlowControl::submit(tag, numRequests, GASPI_OP_WRITE_NOTIFY,
+					segment_id_local, offset_local, rank,
+					segment_id_remote, offset_remote, size,
+					notification_id, notification_value,
+					queue);
+	} else {
+		eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY, tag,
+					segment_id_local, offset_local, rank,
+					segment_id_remote, offset_remote, size,
+					notification_id, notification_value,
+					queue, GASPI_BLOCK);
+		assert(eret != GASPI_TIMEOUT);
+	}
 
 	if (eret != GASPI_SUCCESS) {
 		TaskingModel::decreaseTaskEvents(task, numRequests);
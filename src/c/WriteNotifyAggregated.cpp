@@ -0,0 +1,88 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Aggregation.hpp"
+#include "common/Environment.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_aggregation_enable(const gaspi_segment_id_t segment_id,
+		const gaspi_size_t buffer_size,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	if (Aggregation::isEnabled()) {
+		fprintf(stderr, "Error: Aggregation is already enabled\n");
+		return GASPI_ERROR;
+	}
+
+	return Aggregation::enable(segment_id, buffer_size, queue);
+}
+
+gaspi_return_t
+tagaspi_aggregation_disable()
+{
+	assert(_env.enabled);
+
+	if (!Aggregation::isEnabled()) {
+		fprintf(stderr, "Error: Aggregation is not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	return Aggregation::disable();
+}
+
+gaspi_return_t
+tagaspi_write_notify_aggregated(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value)
+{
+	assert(_env.enabled);
+
+	if (!Aggregation::isEnabled()) {
+		fprintf(stderr, "Error: Aggregation is not enabled\n");
+		return GASPI_ERROR;
+	}
+
+	// The payload is copied, so the task does not wait for the record
+	if (Aggregation::write(segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			notification_id, notification_value))
+		return GASPI_SUCCESS;
+
+	// Post large records directly when no previous record to the rank is
+	// pending, so they cannot overtake the aggregated ones
+	return tagaspi_write_notify(segment_id_local, offset_local, rank,
+			segment_id_remote, offset_remote, size,
+			notification_id, notification_value,
+			Aggregation::getQueue());
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -0,0 +1,119 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Environment.hpp"
+#include "common/FlowControl.hpp"
+#include "common/QueueGroup.hpp"
+#include "common/TaskingModel.hpp"
+#include "common/util/RCU.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_write_notify_multi(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_number_t num,
+		const gaspi_rank_t ranks[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_group_id_t queue_group)
+{
+	assert(_env.enabled);
+	assert(queue_group < _env.maxQueueGroups);
+
+	if (num == 0)
+		return GASPI_SUCCESS;
+
+	// Prevent the group from being released while in use
+	util::RCUReadGuard guard;
+
+	QueueGroup *queueGroup = _env.queueGroups.get(queue_group);
+	if (queueGroup == nullptr) {
+		fprintf(stderr, "Error: Queue group %d does not exist\n", queue_group);
+		return GASPI_ERROR;
+	}
+
+	QueueGroup *subgroup = queueGroup->getSubgroup(size);
+	assert(subgroup != nullptr);
+
+	gaspi_rank_t self;
+	gaspi_return_t eret = gaspi_proc_rank(&self);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+	assert(task != NULL);
+
+	gaspi_tag_t tag = (gaspi_tag_t) task;
+
+	gaspi_number_t numRequests = _env.numRequests[Operation::WRITE_NOTIFY];
+	assert(numRequests > 0);
+
+	// A single increase for the writes to all ranks
+	TaskingModel::increaseCurrentTaskEvents(task, (uint64_t) num * numRequests);
+
+	// Rotate the start so that the callers do not target the same rank
+	const gaspi_number_t start = self % num;
+
+	const gaspi_number_t numQueues = subgroup->getNumQueues();
+	assert(numQueues > 0);
+
+	// Unless the policy ties queues to ranks, spread the writes across the
+	// queues starting at the one chosen by the group policy
+	const bool byRank = subgroup->requiresRank();
+	const gaspi_number_t base = byRank ? 0 : subgroup->getOffset() % numQueues;
+
+	for (gaspi_number_t i = 0; i < num; ++i) {
+		const gaspi_number_t r = (start + i) % num;
+		const gaspi_queue_id_t queue = byRank ? subgroup->getQueue(ranks[r])
+					: subgroup->getQueueAt((base + i) % numQueues);
+
+		if (FlowControl::isEnabled()) {
+			eret = FlowControl::submit(tag, numRequests, GASPI_OP_WRITE_NOTIFY,
+						segment_id_local, offset_local, ranks[r],
+						segment_id_remote, offsets_remote[r], size,
+						notification_id, notification_value,
+						queue);
+		} else {
+			eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY, tag,
+						segment_id_local, offset_local, ranks[r],
+						segment_id_remote, offsets_remote[r], size,
+						notification_id, notification_value,
+						queue, GASPI_BLOCK);
+			assert(eret != GASPI_TIMEOUT);
+		}
+
+		if (eret != GASPI_SUCCESS) {
+			// Discount the writes that were not submitted
+			TaskingModel::decreaseTaskEvents(task, (uint64_t) (num - i) * numRequests);
+			return eret;
+		}
+	}
+
+	return GASPI_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
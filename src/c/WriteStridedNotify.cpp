@@ -0,0 +1,65 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "common/Environment.hpp"
+#include "common/StridedList.hpp"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace tagaspi;
+
+#pragma GCC visibility push(default)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gaspi_return_t
+tagaspi_write_strided_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue)
+{
+	assert(_env.enabled);
+
+	if (dims == 0 || counts == nullptr || (dims > 1 && (strides_local == nullptr || strides_remote == nullptr))) {
+		fprintf(stderr, "Error: Invalid dimensions of strided transfer\n");
+		return GASPI_ERROR;
+	}
+
+	if (StridedList::isEmpty(dims, counts))
+		return tagaspi_notify(segment_id_remote, rank,
+				notification_id, notification_value, queue);
+
+	OperationList list = StridedList::get(
+		segment_id_local, offset_local, strides_local,
+		segment_id_remote, offset_remote, strides_remote,
+		dims, counts);
+
+	return tagaspi_write_list_notify(list.num, list.segmentLocal, list.offsetLocal, rank,
+			list.segmentRemote, list.offsetRemote, list.size,
+			segment_id_remote, notification_id, notification_value,
+			queue);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma GCC visibility pop
@@ -0,0 +1,453 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Aggregation.hpp"
+#include "Environment.hpp"
+#include "Polling.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace tagaspi {
+
+bool Aggregation::_enabled = false;
+gaspi_segment_id_t Aggregation::_segment;
+char *Aggregation::_segmentPtr = nullptr;
+gaspi_queue_id_t Aggregation::_queue;
+gaspi_size_t Aggregation::_bufferSize = 0;
+uint64_t Aggregation::_timeout = 100;
+gaspi_rank_t Aggregation::_rank;
+gaspi_rank_t Aggregation::_numRanks = 0;
+Aggregation::Destination *Aggregation::_destinations = nullptr;
+Aggregation::Source *Aggregation::_sources = nullptr;
+TaskingModel::PollingInstance *Aggregation::_pollingInstance = nullptr;
+SpinLock Aggregation::_progressLock;
+
+uint64_t Aggregation::getTime()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+gaspi_return_t Aggregation::enable(gaspi_segment_id_t segment, gaspi_size_t bufferSize, gaspi_queue_id_t queue)
+{
+	assert(!_enabled);
+
+	if (bufferSize <= sizeof(RecordHeader)) {
+		fprintf(stderr, "Error: Aggregation buffers must be larger than %zu bytes\n", sizeof(RecordHeader));
+		return GASPI_ERROR;
+	}
+
+	gaspi_return_t eret;
+	eret = gaspi_proc_rank(&_rank);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	eret = gaspi_proc_num(&_numRanks);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	// Two notifications per rank are required
+	gaspi_number_t numNotifications;
+	eret = gaspi_notification_num(&numNotifications);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	if (numNotifications < 2 * (gaspi_number_t) _numRanks) {
+		fprintf(stderr, "Error: Not enough notifications for the aggregation segment\n");
+		return GASPI_ERROR;
+	}
+
+	_segment = segment;
+	_queue = queue;
+	_bufferSize = align(bufferSize);
+
+	// One receiving buffer and two sending buffers per rank
+	const gaspi_size_t segmentSize = 3 * (gaspi_size_t) _numRanks * _bufferSize;
+
+	eret = gaspi_segment_create(_segment, segmentSize, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_pointer_t pointer;
+	eret = gaspi_segment_ptr(_segment, &pointer);
+	assert(eret == GASPI_SUCCESS);
+	_segmentPtr = (char *) pointer;
+
+	_destinations = new Destination[_numRanks];
+	assert(_destinations != nullptr);
+
+	_sources = new Source[_numRanks];
+	assert(_sources != nullptr);
+
+	// The TAGASPI_AGGREGATION_TIMEOUT envar determines the maximum time in
+	// microseconds that a record waits in a partially filled buffer
+	EnvironmentVariable<uint64_t> timeout("TAGASPI_AGGREGATION_TIMEOUT", 100);
+	_timeout = timeout;
+
+	_enabled = true;
+
+	_pollingInstance = TaskingModel::registerPolling("TAGASPI AGGREGATION", poll, nullptr);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t Aggregation::disable()
+{
+	assert(_enabled);
+
+	for (gaspi_rank_t rank = 0; rank < _numRanks; ++rank) {
+		Destination &destination = _destinations[rank];
+		std::lock_guard<SpinLock> guard(destination.lock);
+		destination.flushRequested = true;
+	}
+
+	// Wait until all buffers to other ranks have been acknowledged
+	bool pending = true;
+	while (pending) {
+		pending = false;
+		for (gaspi_rank_t rank = 0; rank < _numRanks && !pending; ++rank) {
+			Destination &destination = _destinations[rank];
+			std::lock_guard<SpinLock> guard(destination.lock);
+			pending = (destination.numRecords > 0 || destination.inFlight
+				|| !destination.parked.empty());
+		}
+
+		if (pending) {
+			progress();
+			util::spinWait();
+		}
+	}
+
+	// Keep unpacking incoming buffers until all ranks have finished
+	gaspi_return_t eret;
+	while ((eret = gaspi_barrier(GASPI_GROUP_ALL, GASPI_TEST)) == GASPI_TIMEOUT) {
+		progress();
+	}
+
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::unregisterPolling(_pollingInstance);
+	_pollingInstance = nullptr;
+
+	_enabled = false;
+
+	delete [] _destinations;
+	delete [] _sources;
+	_destinations = nullptr;
+	_sources = nullptr;
+	_segmentPtr = nullptr;
+
+	return gaspi_segment_delete(_segment);
+}
+
+bool Aggregation::write(
+	gaspi_segment_id_t segmentLocal,
+	gaspi_offset_t offsetLocal,
+	gaspi_rank_t rank,
+	gaspi_segment_id_t segmentRemote,
+	gaspi_offset_t offsetRemote,
+	gaspi_size_t size,
+	gaspi_notification_id_t notificationId,
+	gaspi_notification_t notificationValue
+) {
+	assert(_enabled);
+	assert(rank < _numRanks);
+
+	gaspi_pointer_t source;
+	if (gaspi_segment_ptr(segmentLocal, &source) != GASPI_SUCCESS)
+		return false;
+
+	RecordHeader header;
+	header.offset = offsetRemote;
+	header.size = size;
+	header.notificationValue = notificationValue;
+	header.notificationId = notificationId;
+	header.segment = segmentRemote;
+
+	const bool direct = (getRecordSize(size) > _bufferSize);
+	const char *payload = (const char *) source + offsetLocal;
+
+	Destination &destination = _destinations[rank];
+	std::lock_guard<SpinLock> guard(destination.lock);
+
+	if (destination.parked.empty()) {
+		// Large records can be written directly once nothing precedes them
+		if (direct && destination.numRecords == 0 && !destination.inFlight)
+			return false;
+
+		if (!direct) {
+			// Send the current buffer if the record does not fit
+			if (destination.used + getRecordSize(size) <= _bufferSize || flush(rank, destination)) {
+				stage(rank, destination, header, payload);
+				return true;
+			}
+		}
+	}
+
+	// Park the record behind the previous ones to the rank
+	destination.parked.emplace_back();
+	ParkedRecord &record = destination.parked.back();
+	record.header = header;
+	record.direct = direct;
+	record.segmentLocal = segmentLocal;
+	record.offsetLocal = offsetLocal;
+	record.task = nullptr;
+
+	if (direct) {
+		// The task waits for the write, since its payload is not copied
+		record.task = TaskingModel::getCurrentTask();
+		assert(record.task != nullptr);
+
+		TaskingModel::increaseCurrentTaskEvents(record.task,
+			_env.numRequests[Operation::WRITE_NOTIFY]);
+	} else {
+		record.payload.assign(payload, payload + size);
+	}
+
+	progressParked(rank, destination);
+
+	return true;
+}
+
+void Aggregation::stage(gaspi_rank_t rank, Destination &destination,
+	const RecordHeader &header, const char *payload)
+{
+	const gaspi_size_t recordSize = getRecordSize(header.size);
+	assert(destination.used + recordSize <= _bufferSize);
+
+	char *buffer = _segmentPtr + getSendOffset(rank, destination.filling) + destination.used;
+
+	std::memcpy(buffer, &header, sizeof(RecordHeader));
+	std::memcpy(buffer + sizeof(RecordHeader), payload, header.size);
+
+	if (destination.numRecords == 0)
+		destination.firstRecordTime = getTime();
+
+	destination.used += recordSize;
+	destination.numRecords += 1;
+
+	// Send the buffer as soon as no other record fits
+	if (destination.used + sizeof(RecordHeader) >= _bufferSize)
+		flush(rank, destination);
+}
+
+void Aggregation::progressParked(gaspi_rank_t rank, Destination &destination)
+{
+	while (!destination.parked.empty()) {
+		ParkedRecord &record = destination.parked.front();
+
+		if (record.direct) {
+			// Send the previous records and wait for their acknowledgement
+			if (destination.numRecords > 0) {
+				flush(rank, destination);
+				return;
+			}
+			if (destination.inFlight)
+				return;
+
+			const RecordHeader &header = record.header;
+			gaspi_return_t eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY,
+						(gaspi_tag_t) record.task,
+						record.segmentLocal, record.offsetLocal, rank,
+						header.segment, header.offset, header.size,
+						header.notificationId, header.notificationValue,
+						_queue, GASPI_TEST);
+			if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+				return;
+
+			ErrorHandler::failIf(eret != GASPI_SUCCESS,
+				"Return code ", (int) eret, " when writing a parked aggregated record");
+		} else {
+			if (destination.used + getRecordSize(record.header.size) > _bufferSize) {
+				if (!flush(rank, destination))
+					return;
+			}
+			stage(rank, destination, record.header, record.payload.data());
+		}
+
+		destination.parked.pop_front();
+	}
+}
+
+bool Aggregation::flush(gaspi_rank_t rank, Destination &destination)
+{
+	assert(destination.numRecords > 0);
+
+	if (destination.inFlight)
+		return false;
+
+	gaspi_return_t eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY, GASPI_TAG_NULL,
+				_segment, getSendOffset(rank, destination.filling), rank,
+				_segment, getReceiveOffset(_rank), destination.used,
+				_rank, destination.numRecords, _queue, GASPI_TEST);
+	if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+		return false;
+
+	ErrorHandler::failIf(eret != GASPI_SUCCESS,
+		"Return code ", (int) eret, " when sending an aggregation buffer");
+
+	destination.inFlight = true;
+	destination.flushRequested = false;
+	destination.filling ^= 1;
+	destination.used = 0;
+	destination.numRecords = 0;
+
+	return true;
+}
+
+bool Aggregation::unpack(gaspi_rank_t rank)
+{
+	Source &source = _sources[rank];
+	const char *buffer = _segmentPtr + getReceiveOffset(rank);
+
+	gaspi_return_t eret;
+	while (source.remaining > 0) {
+		assert(source.position + sizeof(RecordHeader) <= _bufferSize);
+
+		RecordHeader header;
+		std::memcpy(&header, buffer + source.position, sizeof(RecordHeader));
+
+		gaspi_pointer_t target;
+		eret = gaspi_segment_ptr(header.segment, &target);
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when unpacking an aggregated record");
+
+		std::memcpy((char *) target + header.offset, buffer + source.position + sizeof(RecordHeader), header.size);
+
+		// A later record overwrites the value, as a later notify would do
+		const uint64_t key = ((uint64_t) header.segment << 32) | header.notificationId;
+		auto it = source.notificationIndices.find(key);
+		if (it != source.notificationIndices.end()) {
+			source.notifications[it->second].value = header.notificationValue;
+		} else {
+			source.notificationIndices.emplace(key, source.notifications.size());
+			source.notifications.push_back({header.segment, header.notificationId, header.notificationValue});
+		}
+
+		source.position += sizeof(RecordHeader) + align(header.size);
+		source.remaining -= 1;
+	}
+
+	// Post one notification per distinct notification of the buffer
+	while (source.notified < source.notifications.size()) {
+		const Notification &notification = source.notifications[source.notified];
+
+		eret = gaspi_operation_submit(GASPI_OP_NOTIFY, GASPI_TAG_NULL,
+					0, 0, _rank, notification.segment, 0, 0,
+					notification.id, notification.value,
+					_queue, GASPI_TEST);
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+			return false;
+
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when notifying an aggregated record");
+
+		source.notified += 1;
+	}
+
+	source.notifications.clear();
+	source.notificationIndices.clear();
+	source.notified = 0;
+
+	if (source.acknowledge) {
+		eret = gaspi_operation_submit(GASPI_OP_NOTIFY, GASPI_TAG_NULL,
+					0, 0, rank, _segment, 0, 0,
+					_numRanks + _rank, 1, _queue, GASPI_TEST);
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+			return false;
+
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when acknowledging an aggregation buffer");
+
+		source.acknowledge = false;
+	}
+
+	return true;
+}
+
+void Aggregation::progress()
+{
+	if (!_progressLock.trylock())
+		return;
+
+	gaspi_notification_id_t id;
+	gaspi_notification_t value;
+	gaspi_return_t eret;
+
+	// Release the acknowledged buffers and send the records that
+	// accumulated in the meantime
+	while ((eret = gaspi_notify_waitsome(_segment, _numRanks, _numRanks, &id, GASPI_TEST)) == GASPI_SUCCESS) {
+		gaspi_notify_reset(_segment, id, &value);
+
+		Destination &destination = _destinations[id - _numRanks];
+		std::lock_guard<SpinLock> guard(destination.lock);
+		destination.inFlight = false;
+		progressParked(id - _numRanks, destination);
+		if (destination.numRecords > 0 && !destination.inFlight)
+			flush(id - _numRanks, destination);
+	}
+	ErrorHandler::failIf(eret != GASPI_TIMEOUT,
+		"Return code ", (int) eret, " when checking aggregation acknowledgements");
+
+	// Stage the parked records and send the buffers that timed out
+	const uint64_t now = getTime();
+	for (gaspi_rank_t rank = 0; rank < _numRanks; ++rank) {
+		Destination &destination = _destinations[rank];
+		std::lock_guard<SpinLock> guard(destination.lock);
+		if (!destination.parked.empty())
+			progressParked(rank, destination);
+		if (destination.numRecords > 0 && !destination.inFlight) {
+			if (destination.flushRequested || now - destination.firstRecordTime >= _timeout)
+				flush(rank, destination);
+		}
+	}
+
+	// Resume the buffers that could not be fully unpacked
+	bool blocked = false;
+	for (gaspi_rank_t rank = 0; rank < _numRanks && !blocked; ++rank) {
+		const Source &source = _sources[rank];
+		if (source.remaining > 0 || !source.notifications.empty() || source.acknowledge)
+			blocked = !unpack(rank);
+	}
+
+	// Unpack the incoming buffers
+	while (!blocked && (eret = gaspi_notify_waitsome(_segment, 0, _numRanks, &id, GASPI_TEST)) == GASPI_SUCCESS) {
+		gaspi_notify_reset(_segment, id, &value);
+		assert(value > 0);
+
+		Source &source = _sources[id];
+		assert(source.remaining == 0 && source.notifications.empty() && !source.acknowledge);
+
+		source.remaining = value;
+		source.position = 0;
+		source.acknowledge = true;
+
+		blocked = !unpack(id);
+	}
+	ErrorHandler::failIf(eret != GASPI_SUCCESS && eret != GASPI_TIMEOUT,
+		"Return code ", (int) eret, " when checking aggregation buffers");
+
+	_progressLock.unlock();
+}
+
+uint64_t Aggregation::poll(void *)
+{
+	progress();
+
+	return Polling::getPeriod();
+}
+
+} // namespace tagaspi
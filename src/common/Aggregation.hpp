@@ -0,0 +1,254 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef AGGREGATION_HPP
+#define AGGREGATION_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+#include "util/Utils.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that aggregates small write-notify operations targeting the same
+//! rank. The payloads are copied into a per-destination staging buffer of
+//! a dedicated segment, which is sent as a single write with notification
+//! once full or after a timeout. The notification value carries the number
+//! of records. The polling instance of the receiver copies each record to
+//! its target offset, posts the notifications and acknowledges the buffer.
+//! The records of a buffer with the same notification share a single post
+//!
+//! The records to a rank are applied in calling order. Those that find no
+//! free buffer are parked with a copy of their payload until a buffer frees
+//! up. Records larger than a buffer are written directly, but only once the
+//! previous records to the rank have been acknowledged; until then, they
+//! are parked and hold an event of the calling task
+//!
+//! The staging segment is split in a receiving area, with one buffer per
+//! source rank, and a sending area, with two buffers per destination rank:
+//! one being filled and one in flight until acknowledged. The notification
+//! identifiers [0, numRanks) signal incoming buffers, and the identifiers
+//! [numRanks, 2 * numRanks) signal acknowledgements
+class Aggregation {
+private:
+	//! The header of a record in a staging buffer
+	struct RecordHeader {
+		gaspi_offset_t offset;
+		gaspi_size_t size;
+		gaspi_notification_t notificationValue;
+		gaspi_notification_id_t notificationId;
+		gaspi_segment_id_t segment;
+	};
+
+	//! A notification to post after unpacking the records of a buffer
+	struct Notification {
+		gaspi_segment_id_t segment;
+		gaspi_notification_id_t id;
+		gaspi_notification_t value;
+	};
+
+	//! A record waiting for a free buffer or for the previous records
+	struct ParkedRecord {
+		RecordHeader header;
+
+		//! The copied payload of records to aggregate
+		std::vector<char> payload;
+
+		//! Whether the record is written directly instead of aggregated
+		bool direct;
+
+		//! The source of direct records and the task waiting for them
+		gaspi_segment_id_t segmentLocal;
+		gaspi_offset_t offsetLocal;
+		TaskingModel::task_handle_t task;
+	};
+
+	//! The state of the buffers targeting a rank
+	struct alignas(CACHELINE_SIZE) Destination {
+		//! The lock protecting the state
+		SpinLock lock;
+
+		//! The index of the buffer being filled
+		int filling;
+
+		//! Whether the other buffer was sent and not acknowledged
+		bool inFlight;
+
+		//! Whether the buffer should be sent regardless of the timeout
+		bool flushRequested;
+
+		//! The bytes and records in the buffer being filled
+		gaspi_size_t used;
+		gaspi_notification_t numRecords;
+
+		//! The time in microseconds of the first record in the buffer
+		uint64_t firstRecordTime;
+
+		//! The records waiting to be staged or written, in calling order
+		std::deque<ParkedRecord> parked;
+
+		Destination() :
+			lock(), filling(0), inFlight(false), flushRequested(false),
+			used(0), numRecords(0), firstRecordTime(0), parked()
+		{
+		}
+	};
+
+	//! The state of the buffer received from a rank
+	struct Source {
+		//! The records pending to unpack
+		gaspi_notification_t remaining;
+
+		//! The position of the next record in the buffer
+		gaspi_size_t position;
+
+		//! The notifications of the unpacked records, where the records
+		//! with the same notification share a single entry
+		std::vector<Notification> notifications;
+		std::unordered_map<uint64_t, size_t> notificationIndices;
+
+		//! The notifications posted so far
+		size_t notified;
+
+		//! Whether the buffer must be acknowledged
+		bool acknowledge;
+
+		Source() :
+			remaining(0), position(0),
+			notifications(), notificationIndices(),
+			notified(0), acknowledge(false)
+		{
+		}
+	};
+
+	static bool _enabled;
+
+	//! The staging segment, its local address and the queue to post
+	static gaspi_segment_id_t _segment;
+	static char *_segmentPtr;
+	static gaspi_queue_id_t _queue;
+
+	//! The size of each staging buffer
+	static gaspi_size_t _bufferSize;
+
+	//! The timeout in microseconds to send partially filled buffers
+	static uint64_t _timeout;
+
+	static gaspi_rank_t _rank;
+	static gaspi_rank_t _numRanks;
+
+	static Destination *_destinations;
+	static Source *_sources;
+
+	static TaskingModel::PollingInstance *_pollingInstance;
+
+	//! The lock ensuring a single thread processes incoming buffers
+	static SpinLock _progressLock;
+
+	static inline gaspi_size_t align(gaspi_size_t size)
+	{
+		return (size + sizeof(uint64_t) - 1) & ~(gaspi_size_t) (sizeof(uint64_t) - 1);
+	}
+
+	static inline gaspi_offset_t getReceiveOffset(gaspi_rank_t source)
+	{
+		return (gaspi_offset_t) source * _bufferSize;
+	}
+
+	static inline gaspi_offset_t getSendOffset(gaspi_rank_t destination, int buffer)
+	{
+		return ((gaspi_offset_t) _numRanks + 2 * destination + buffer) * _bufferSize;
+	}
+
+	static uint64_t getTime();
+
+	static inline gaspi_size_t getRecordSize(gaspi_size_t size)
+	{
+		return sizeof(RecordHeader) + align(size);
+	}
+
+	//! \brief Copy a record into the buffer being filled
+	//!
+	//! The lock of the destination must be held by the caller, and the
+	//! record must fit in the buffer
+	static void stage(gaspi_rank_t rank, Destination &destination,
+		const RecordHeader &header, const char *payload);
+
+	//! \brief Stage or write the parked records of a rank in order
+	//!
+	//! The lock of the destination must be held by the caller
+	static void progressParked(gaspi_rank_t rank, Destination &destination);
+
+	//! \brief Send the buffer being filled if the previous one was acknowledged
+	//!
+	//! The lock of the destination must be held by the caller
+	//!
+	//! \returns Whether the buffer was sent
+	static bool flush(gaspi_rank_t rank, Destination &destination);
+
+	//! \brief Unpack the records of an incoming buffer
+	//!
+	//! \returns Whether all records were unpacked and acknowledged
+	static bool unpack(gaspi_rank_t source);
+
+	//! \brief Process acknowledgements, incoming buffers and timeouts
+	static void progress();
+
+	static uint64_t poll(void *data);
+
+public:
+	static inline bool isEnabled()
+	{
+		return _enabled;
+	}
+
+	//! \brief Get the queue of the staging buffers and notifications
+	static inline gaspi_queue_id_t getQueue()
+	{
+		return _queue;
+	}
+
+	//! \brief Create the staging segment and start the aggregation
+	//!
+	//! This function is collective over all ranks
+	static gaspi_return_t enable(gaspi_segment_id_t segment, gaspi_size_t bufferSize, gaspi_queue_id_t queue);
+
+	//! \brief Send all pending buffers and release the staging segment
+	//!
+	//! This function is collective over all ranks
+	static gaspi_return_t disable();
+
+	//! \brief Copy a write with notification into the staging buffer
+	//!
+	//! The record is parked if it cannot be staged or written yet without
+	//! overtaking the previous records to the rank
+	//!
+	//! \returns Whether the record was aggregated or parked; otherwise, the
+	//!          caller must post the operation directly
+	static bool write(
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue
+	);
+};
+
+} // namespace tagaspi
+
+#endif // AGGREGATION_HPP
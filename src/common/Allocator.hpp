@@ -72,6 +72,23 @@ public:
 		return object;
 	}
 
+	//! \brief Allocate an object without waiting for a free entry
+	//!
+	//! \returns The object or nullptr if all entries are in use
+	template<typename... Args>
+	static inline T *tryAllocate(Args &&... args)
+	{
+		assert(initialized());
+		T *object = nullptr;
+
+		if (!_queue->pop(object))
+			return nullptr;
+		assert(object != nullptr);
+
+		new (object) T(std::forward<Args>(args)...);
+		return object;
+	}
+
 	static inline void free(T *object)
 	{
 		assert(initialized());
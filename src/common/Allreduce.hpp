@@ -0,0 +1,320 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef ALLREDUCE_HPP
+#define ALLREDUCE_HPP
+
+#include <GASPI.h>
+
+#include "Collectives.hpp"
+#include "Reduction.hpp"
+#include "TaskingModel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace tagaspi {
+
+//! Collective operation implementing a recursive doubling allreduce. The
+//! data is split into chunks, which go through the algorithm independently
+//! so that the reduction of a chunk overlaps the transfers of the next one
+//!
+//! Groups whose size is not a power of two fold their first members in
+//! pairs: in the first step, each odd member sends its data to the previous
+//! member, and in the last step, it receives the result from that member.
+//! The rest of members run the recursive doubling rounds, where each one
+//! exchanges its partial result with the member at distance 2^r
+//!
+//! The chunks of a group area are indexed by step and buffer. Each step has
+//! a sending chunk, which holds the partial result to send in that step,
+//! and a receiving chunk, which gets the partial result of the peer
+class AllreduceOperation : public Collectives::CollectiveOperation {
+private:
+	//! The role of this rank in the folding of the group
+	enum Role {
+		//! Sends its data to the previous member and receives the result
+		FOLDED = 0,
+		//! Receives the data of the next member and sends the result
+		HOST,
+		//! Only runs the recursive doubling rounds
+		REGULAR,
+	};
+
+	//! The stage of a chunk
+	enum Stage {
+		INITIAL = 0,
+		FOLDING,
+		ROUNDS,
+		UNFOLDING,
+		FINISHED,
+	};
+
+	//! The state of a chunk in flight
+	struct ChunkState {
+		Stage stage;
+		gaspi_number_t round;
+		bool sent;
+
+		//! The data chunk holding the current partial result
+		gaspi_number_t current;
+	};
+
+	const char *_input;
+	char *_output;
+	gaspi_number_t _num;
+	gaspi_operation_t _reduction;
+	gaspi_datatype_t _type;
+	size_t _typeSize;
+
+	//! The elements per chunk and the number of chunks
+	gaspi_number_t _chunkElements;
+	uint32_t _numChunks;
+
+	//! The oldest unfinished chunk and the next chunk to start
+	uint32_t _first;
+	uint32_t _next;
+
+	ChunkState _states[Collectives::Window];
+
+	//! The folding of the group
+	Role _role;
+	gaspi_number_t _virtualPosition;
+	gaspi_number_t _numRounds;
+	gaspi_number_t _numFolded;
+
+	inline gaspi_number_t getFoldStep() const
+	{
+		return 0;
+	}
+
+	inline gaspi_number_t getUnfoldStep() const
+	{
+		return Collectives::getNumSteps() - 1;
+	}
+
+	inline gaspi_number_t getSendChunk(gaspi_number_t step, gaspi_number_t buffer) const
+	{
+		return step * Collectives::NumBuffers + buffer;
+	}
+
+	inline gaspi_number_t getReceiveChunk(gaspi_number_t step, gaspi_number_t buffer) const
+	{
+		return (Collectives::getNumSteps() + step) * Collectives::NumBuffers + buffer;
+	}
+
+	inline gaspi_number_t getNotificationIndex(gaspi_number_t step, gaspi_number_t buffer) const
+	{
+		return step * Collectives::NumBuffers + buffer;
+	}
+
+	//! \brief Get the member of a position among the non-folded members
+	inline gaspi_number_t getMember(gaspi_number_t virtualPosition) const
+	{
+		if (virtualPosition < _numFolded)
+			return 2 * virtualPosition;
+		return virtualPosition + _numFolded;
+	}
+
+	//! \brief Compute the role of this rank in the group
+	inline void setupFolding(const Collectives::Group &members)
+	{
+		const gaspi_number_t size = members.size();
+
+		gaspi_number_t power = 1;
+		_numRounds = 0;
+		while (power * 2 <= size) {
+			power *= 2;
+			++_numRounds;
+		}
+		_numFolded = size - power;
+
+		const gaspi_number_t position = members.position;
+		if (position < 2 * _numFolded) {
+			_role = (position % 2) ? FOLDED : HOST;
+			_virtualPosition = position / 2;
+		} else {
+			_role = REGULAR;
+			_virtualPosition = position - _numFolded;
+		}
+	}
+
+	//! \brief Advance a chunk as much as possible
+	//!
+	//! \returns Whether the chunk has finished
+	inline bool progressChunk(Collectives::Group &members, uint32_t chunk, ChunkState &state)
+	{
+		const uint32_t chunkSequence = sequence + chunk;
+		const gaspi_number_t buffer = chunkSequence % Collectives::NumBuffers;
+		const gaspi_number_t first = chunk * _chunkElements;
+		const gaspi_number_t elements = std::min(_chunkElements, _num - first);
+		const gaspi_size_t size = elements * _typeSize;
+		const Collectives::NotificationArea area = Collectives::ALLREDUCE_AREA;
+
+		if (state.stage == INITIAL) {
+			state.current = getSendChunk(getFoldStep(), buffer);
+			std::memcpy(Collectives::getChunk(group, state.current), _input + first * _typeSize, size);
+
+			state.stage = (_role == REGULAR) ? ROUNDS : FOLDING;
+			state.round = 0;
+			state.sent = false;
+		}
+
+		if (state.stage == FOLDING) {
+			const gaspi_number_t step = getFoldStep();
+			const gaspi_number_t index = getNotificationIndex(step, buffer);
+
+			if (_role == FOLDED) {
+				if (!state.sent) {
+					if (!Collectives::write(*this, members, members.position - 1, state.current,
+							getReceiveChunk(step, buffer), size, area, index, chunkSequence))
+						return false;
+					state.sent = true;
+				}
+				state.stage = UNFOLDING;
+			} else {
+				if (!Collectives::arrived(*this, members, area, index, chunkSequence))
+					return false;
+
+				const gaspi_number_t result = getSendChunk(step + 1, buffer);
+				Reduction::reduce(_reduction, _type,
+					Collectives::getChunk(group, result),
+					Collectives::getChunk(group, state.current),
+					Collectives::getChunk(group, getReceiveChunk(step, buffer)),
+					elements);
+
+				state.current = result;
+				state.stage = ROUNDS;
+				state.sent = false;
+			}
+		}
+
+		while (state.stage == ROUNDS && state.round < _numRounds) {
+			const gaspi_number_t step = state.round + 1;
+			const gaspi_number_t index = getNotificationIndex(step, buffer);
+
+			if (!state.sent) {
+				const gaspi_number_t peer = getMember(_virtualPosition ^ ((gaspi_number_t) 1 << state.round));
+				if (!Collectives::write(*this, members, peer, state.current,
+						getReceiveChunk(step, buffer), size, area, index, chunkSequence))
+					return false;
+				state.sent = true;
+			}
+
+			if (!Collectives::arrived(*this, members, area, index, chunkSequence))
+				return false;
+
+			const gaspi_number_t result = getSendChunk(step + 1, buffer);
+			Reduction::reduce(_reduction, _type,
+				Collectives::getChunk(group, result),
+				Collectives::getChunk(group, state.current),
+				Collectives::getChunk(group, getReceiveChunk(step, buffer)),
+				elements);
+
+			state.current = result;
+			state.sent = false;
+			++state.round;
+		}
+
+		if (state.stage == ROUNDS)
+			state.stage = (_role == HOST) ? UNFOLDING : FINISHED;
+
+		if (state.stage == UNFOLDING) {
+			const gaspi_number_t step = getUnfoldStep();
+			const gaspi_number_t index = getNotificationIndex(step, buffer);
+
+			if (_role == HOST) {
+				if (!state.sent) {
+					if (!Collectives::write(*this, members, members.position + 1, state.current,
+							getReceiveChunk(step, buffer), size, area, index, chunkSequence))
+						return false;
+					state.sent = true;
+				}
+			} else {
+				if (!Collectives::arrived(*this, members, area, index, chunkSequence))
+					return false;
+
+				state.current = getReceiveChunk(step, buffer);
+			}
+			state.stage = FINISHED;
+		}
+
+		assert(state.stage == FINISHED);
+		std::memcpy(_output + first * _typeSize, Collectives::getChunk(group, state.current), size);
+
+		return true;
+	}
+
+public:
+	inline AllreduceOperation(
+		TaskingModel::task_handle_t task,
+		gaspi_group_t group,
+		const void *input,
+		void *output,
+		gaspi_number_t num,
+		gaspi_operation_t reduction,
+		gaspi_datatype_t type
+	) :
+		CollectiveOperation(task, group),
+		_input(static_cast<const char *>(input)),
+		_output(static_cast<char *>(output)),
+		_num(num),
+		_reduction(reduction),
+		_type(type),
+		_typeSize(Reduction::getTypeSize(type)),
+		_chunkElements(Collectives::getChunkSize() / _typeSize),
+		_numChunks((num + _chunkElements - 1) / _chunkElements),
+		_first(0),
+		_next(0),
+		_states(),
+		_role(REGULAR),
+		_virtualPosition(0),
+		_numRounds(0),
+		_numFolded(0)
+	{
+		assert(num > 0);
+		assert(_typeSize > 0);
+		assert(_chunkElements > 0);
+
+		numSequences = _numChunks;
+	}
+
+	inline bool progress(Collectives::Group &members) override
+	{
+		if (_first == 0 && _next == 0)
+			setupFolding(members);
+
+		bool advanced = true;
+		while (advanced) {
+			advanced = false;
+
+			// Start the chunks that fit in the window
+			while (_next < _numChunks && _next < _first + Collectives::Window) {
+				ChunkState &state = _states[_next % Collectives::Window];
+				state.stage = INITIAL;
+				++_next;
+			}
+
+			for (uint32_t chunk = _first; chunk < _next; ++chunk) {
+				ChunkState &state = _states[chunk % Collectives::Window];
+				if (state.stage != FINISHED)
+					progressChunk(members, chunk, state);
+			}
+
+			// Retire the finished chunks in order
+			while (_first < _next && _states[_first % Collectives::Window].stage == FINISHED) {
+				++_first;
+				advanced = true;
+			}
+		}
+
+		return (_first == _numChunks);
+	}
+};
+
+} // namespace tagaspi
+
+#endif // ALLREDUCE_HPP
@@ -0,0 +1,83 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+
+#include "Atomics.hpp"
+#include "Polling.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+std::vector<Atomics::PendingAtomic> Atomics::_pending;
+std::atomic<uint64_t> Atomics::_numPending(0);
+SpinLock Atomics::_lock;
+TaskingModel::PollingInstance *Atomics::_pollingInstance = nullptr;
+
+void Atomics::initialize()
+{
+	assert(_pollingInstance == nullptr);
+
+	_pollingInstance = TaskingModel::registerPolling("TAGASPI ATOMICS", poll, nullptr);
+}
+
+void Atomics::finalize()
+{
+	assert(_numPending.load() == 0);
+
+	TaskingModel::unregisterPolling(_pollingInstance);
+	_pollingInstance = nullptr;
+}
+
+void Atomics::submit(const PendingAtomic &atomic)
+{
+	std::lock_guard<SpinLock> guard(_lock);
+	_pending.push_back(atomic);
+	_numPending.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t Atomics::poll(void *)
+{
+	if (_numPending.load(std::memory_order_acquire) == 0)
+		return Polling::getPeriod();
+
+	std::vector<PendingAtomic> atomics;
+	{
+		std::lock_guard<SpinLock> guard(_lock);
+		atomics.swap(_pending);
+	}
+
+	// Run the atomics in calling order, each one blocking the polling
+	// instance for a round trip instead of a worker thread
+	for (const PendingAtomic &atomic : atomics) {
+		gaspi_atomic_value_t oldValue;
+		gaspi_return_t eret;
+
+		if (atomic.compareSwap) {
+			eret = gaspi_atomic_compare_swap(atomic.segment, atomic.offset, atomic.rank,
+						atomic.comparator, atomic.value, &oldValue, GASPI_BLOCK);
+		} else {
+			eret = gaspi_atomic_fetch_add(atomic.segment, atomic.offset, atomic.rank,
+						atomic.value, &oldValue, GASPI_BLOCK);
+		}
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when running a remote atomic");
+
+		if (atomic.oldValue != nullptr)
+			*atomic.oldValue = oldValue;
+
+		TaskingModel::decreaseTaskEvents(atomic.task, 1);
+	}
+
+	_numPending.fetch_sub(atomics.size(), std::memory_order_relaxed);
+
+	return Polling::getPeriod();
+}
+
+} // namespace tagaspi
@@ -0,0 +1,72 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef ATOMICS_HPP
+#define ATOMICS_HPP
+
+#include <GASPI.h>
+
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that runs the remote atomic operations on behalf of tasks. The
+//! low-level API of GASPI has no request-based atomics, so the atomics are
+//! queued and run by a polling instance instead of the calling task. Once
+//! an atomic finishes, its old value is stored in the location given by the
+//! task, and then a single event of the task is decreased
+class Atomics {
+public:
+	//! An atomic operation waiting to run
+	struct PendingAtomic {
+		TaskingModel::task_handle_t task;
+		bool compareSwap;
+
+		gaspi_segment_id_t segment;
+		gaspi_offset_t offset;
+		gaspi_rank_t rank;
+
+		//! The value to add or to swap and the value to compare with
+		gaspi_atomic_value_t value;
+		gaspi_atomic_value_t comparator;
+
+		//! The location of the old value, which may be null
+		gaspi_atomic_value_t *oldValue;
+	};
+
+private:
+	//! The atomics in calling order
+	static std::vector<PendingAtomic> _pending;
+
+	//! The number of atomics waiting to run
+	static std::atomic<uint64_t> _numPending;
+
+	//! The lock protecting the pending atomics
+	static SpinLock _lock;
+
+	static TaskingModel::PollingInstance *_pollingInstance;
+
+	static uint64_t poll(void *data);
+
+public:
+	static void initialize();
+
+	static void finalize();
+
+	//! \brief Queue an atomic operation
+	//!
+	//! The caller must have increased an event of the task
+	static void submit(const PendingAtomic &atomic);
+};
+
+} // namespace tagaspi
+
+#endif // ATOMICS_HPP
@@ -0,0 +1,61 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef BARRIER_HPP
+#define BARRIER_HPP
+
+#include <GASPI.h>
+
+#include "Collectives.hpp"
+#include "TaskingModel.hpp"
+
+namespace tagaspi {
+
+//! Collective operation implementing a dissemination barrier. In the round
+//! r, each member notifies the member at distance 2^r and waits for the
+//! notification of the member at distance -2^r. The barrier finishes
+//! after ceil(log2(n)) rounds
+class BarrierOperation : public Collectives::CollectiveOperation {
+private:
+	//! The current round and whether its notification was posted
+	gaspi_number_t _round;
+	bool _notified;
+
+public:
+	inline BarrierOperation(TaskingModel::task_handle_t task, gaspi_group_t group) :
+		CollectiveOperation(task, group),
+		_round(0),
+		_notified(false)
+	{
+	}
+
+	inline bool progress(Collectives::Group &members) override
+	{
+		const gaspi_number_t size = members.size();
+
+		while (((gaspi_number_t) 1 << _round) < size) {
+			const gaspi_number_t distance = (gaspi_number_t) 1 << _round;
+
+			if (!_notified) {
+				const gaspi_number_t peer = (members.position + distance) % size;
+				if (!Collectives::notify(*this, members, peer, Collectives::BARRIER_AREA, _round, sequence))
+					return false;
+				_notified = true;
+			}
+
+			if (!Collectives::arrived(*this, members, Collectives::BARRIER_AREA, _round, sequence))
+				return false;
+
+			_notified = false;
+			++_round;
+		}
+		return true;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // BARRIER_HPP
@@ -0,0 +1,283 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef BROADCAST_HPP
+#define BROADCAST_HPP
+
+#include <GASPI.h>
+
+#include "Collectives.hpp"
+#include "CounterCompletion.hpp"
+#include "Environment.hpp"
+#include "TaskingModel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+namespace tagaspi {
+
+//! Collective operation implementing a pipelined tree broadcast. The data
+//! is split into chunks, which flow down the tree through a buffer of each
+//! rank: a rank copies each chunk out of its buffer once it arrives and
+//! forwards it to its children from the same buffer. Broadcasts with fewer
+//! chunks than members use a binomial tree, and the rest use a chain,
+//! where the root only sends the data once
+//!
+//! A parent reuses the buffer of a child once the child acknowledges the
+//! chunk that was there, which is after copying it out and completing its
+//! own forwards. At the start of each broadcast, the children tell their
+//! parents that they are ready, since the tree may differ from the previous
+//! broadcast of the group
+class BroadcastOperation : public Collectives::CollectiveOperation {
+private:
+	//! The stage of a chunk
+	enum Stage {
+		RECEIVING = 0,
+		FORWARDING,
+		ACKNOWLEDGING,
+		FINISHED,
+	};
+
+	//! The state of a chunk in flight
+	struct ChunkState {
+		Stage stage;
+
+		//! Whether the forwards were accounted and the children to which
+		//! the chunk was forwarded
+		bool accounted;
+		size_t forwarded;
+	};
+
+	//! A child in the tree and the index of this rank's edge to it
+	struct Child {
+		gaspi_number_t member;
+		gaspi_number_t index;
+	};
+
+	char *_buffer;
+	gaspi_size_t _size;
+	gaspi_rank_t _root;
+
+	uint32_t _numChunks;
+
+	//! The oldest unfinished chunk and the next chunk to start
+	uint32_t _first;
+	uint32_t _next;
+
+	ChunkState _states[Collectives::NumBuffers];
+
+	//! The completion of the forwards from each buffer
+	CounterCompletion _forwards[Collectives::NumBuffers];
+
+	//! The tree as seen by this rank
+	bool _initialized;
+	bool _isRoot;
+	gaspi_number_t _parent;
+	gaspi_number_t _index;
+	std::vector<Child> _children;
+
+	//! Whether the parent was told that this rank is ready
+	bool _ready;
+
+	inline gaspi_number_t getDataChunk(gaspi_number_t buffer) const
+	{
+		return 2 * Collectives::getNumSteps() * Collectives::NumBuffers + buffer;
+	}
+
+	inline gaspi_number_t getAckIndex(gaspi_number_t edge, gaspi_number_t buffer) const
+	{
+		return edge * Collectives::NumBuffers + buffer;
+	}
+
+	//! \brief Build the tree over the virtual positions relative to the root
+	inline void initialize(const Collectives::Group &members)
+	{
+		const gaspi_number_t size = members.size();
+
+		gaspi_number_t root = size;
+		for (gaspi_number_t m = 0; m < size; ++m) {
+			if (members.ranks[m] == _root)
+				root = m;
+		}
+		// The root was checked when the broadcast was called
+		assert(root < size);
+
+		const gaspi_number_t virtualPosition = (members.position + size - root) % size;
+		_isRoot = (virtualPosition == 0);
+
+		if (_numChunks >= size) {
+			// Chain: each member forwards to the next one
+			if (!_isRoot) {
+				_parent = (virtualPosition - 1 + root) % size;
+				_index = 0;
+			}
+			if (virtualPosition + 1 < size)
+				_children.push_back({(virtualPosition + 1 + root) % size, 0});
+		} else {
+			// Binomial: the member v receives from v minus its highest bit
+			gaspi_number_t first = 0;
+			if (!_isRoot) {
+				gaspi_number_t bit = 0;
+				while (((gaspi_number_t) 2 << bit) <= virtualPosition)
+					++bit;
+				_parent = (virtualPosition - ((gaspi_number_t) 1 << bit) + root) % size;
+				_index = bit;
+				first = bit + 1;
+			}
+
+			// Send to the largest subtrees first
+			for (gaspi_number_t bit = Collectives::MaxRounds; bit > first; --bit) {
+				const gaspi_number_t distance = (gaspi_number_t) 1 << (bit - 1);
+				if (virtualPosition + distance < size)
+					_children.push_back({(virtualPosition + distance + root) % size, bit - 1});
+			}
+		}
+
+		_initialized = true;
+	}
+
+	//! \brief Advance a chunk as much as possible
+	inline void progressChunk(Collectives::Group &members, uint32_t chunk, ChunkState &state)
+	{
+		const uint32_t chunkSequence = sequence + chunk;
+		const gaspi_number_t buffer = chunkSequence % Collectives::NumBuffers;
+		const gaspi_size_t offset = (gaspi_size_t) chunk * Collectives::getChunkSize();
+		const gaspi_size_t size = std::min(Collectives::getChunkSize(), _size - offset);
+		char *data = Collectives::getChunk(group, getDataChunk(buffer));
+
+		if (state.stage == RECEIVING) {
+			if (_isRoot) {
+				std::memcpy(data, _buffer + offset, size);
+			} else {
+				if (!Collectives::arrived(*this, members, Collectives::BROADCAST_DATA_AREA, buffer, chunkSequence))
+					return;
+				std::memcpy(_buffer + offset, data, size);
+			}
+			state.stage = FORWARDING;
+			state.accounted = false;
+			state.forwarded = 0;
+		}
+
+		while (state.stage == FORWARDING && state.forwarded < _children.size()) {
+			const Child &child = _children[state.forwarded];
+
+			// The buffer of the child must be free
+			if (chunk < Collectives::NumBuffers) {
+				if (!Collectives::arrived(*this, members, Collectives::BROADCAST_READY_AREA,
+						child.index, sequence))
+					return;
+			} else {
+				if (!Collectives::arrived(*this, members, Collectives::BROADCAST_ACK_AREA,
+						getAckIndex(child.index, buffer), chunkSequence - Collectives::NumBuffers))
+					return;
+			}
+
+			CounterCompletion &forwards = _forwards[buffer];
+			if (!state.accounted) {
+				forwards.add(_children.size() * _env.numRequests[Operation::WRITE_NOTIFY]);
+				state.accounted = true;
+			}
+
+			if (!Collectives::write(*this, members, child.member, getDataChunk(buffer),
+					getDataChunk(buffer), size, Collectives::BROADCAST_DATA_AREA,
+					buffer, chunkSequence, forwards.getTag()))
+				return;
+
+			++state.forwarded;
+		}
+
+		if (state.stage == FORWARDING)
+			state.stage = ACKNOWLEDGING;
+
+		if (state.stage == ACKNOWLEDGING) {
+			// The forwards read the buffer until they complete
+			if (!_forwards[buffer].isIdle())
+				return;
+
+			if (!_isRoot) {
+				if (!Collectives::notify(*this, members, _parent, Collectives::BROADCAST_ACK_AREA,
+						getAckIndex(_index, buffer), chunkSequence))
+					return;
+			}
+			state.stage = FINISHED;
+		}
+	}
+
+public:
+	inline BroadcastOperation(
+		TaskingModel::task_handle_t task,
+		gaspi_group_t group,
+		void *buffer,
+		gaspi_size_t size,
+		gaspi_rank_t root
+	) :
+		CollectiveOperation(task, group),
+		_buffer(static_cast<char *>(buffer)),
+		_size(size),
+		_root(root),
+		_numChunks((size + Collectives::getChunkSize() - 1) / Collectives::getChunkSize()),
+		_first(0),
+		_next(0),
+		_states(),
+		_forwards(),
+		_initialized(false),
+		_isRoot(false),
+		_parent(0),
+		_index(0),
+		_children(),
+		_ready(false)
+	{
+		assert(size > 0);
+
+		numSequences = _numChunks;
+	}
+
+	inline bool progress(Collectives::Group &members) override
+	{
+		if (!_initialized)
+			initialize(members);
+
+		if (!_ready) {
+			// The previous collectives of the group released the buffer
+			if (!_isRoot && !Collectives::notify(*this, members, _parent,
+					Collectives::BROADCAST_READY_AREA, _index, sequence))
+				return false;
+			_ready = true;
+		}
+
+		bool advanced = true;
+		while (advanced) {
+			advanced = false;
+
+			// Start the chunks that have a free buffer
+			while (_next < _numChunks && _next < _first + Collectives::NumBuffers) {
+				ChunkState &state = _states[_next % Collectives::NumBuffers];
+				state.stage = RECEIVING;
+				++_next;
+			}
+
+			for (uint32_t chunk = _first; chunk < _next; ++chunk) {
+				ChunkState &state = _states[chunk % Collectives::NumBuffers];
+				if (state.stage != FINISHED)
+					progressChunk(members, chunk, state);
+			}
+
+			// Retire the finished chunks in order
+			while (_first < _next && _states[_first % Collectives::NumBuffers].stage == FINISHED) {
+				++_first;
+				advanced = true;
+			}
+		}
+
+		return (_first == _numChunks);
+	}
+};
+
+} // namespace tagaspi
+
+#endif // BROADCAST_HPP
@@ -0,0 +1,44 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include "ChunkedCompletion.hpp"
+
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+std::deque<ChunkedCompletion *> ChunkedCompletion::_parked;
+SpinLock ChunkedCompletion::_parkedLock;
+std::atomic<uint64_t> ChunkedCompletion::_numParked(0);
+
+void ChunkedCompletion::progress()
+{
+	std::deque<ChunkedCompletion *> finished;
+
+	{
+		std::lock_guard<SpinLock> guard(_parkedLock);
+
+		// Keep the parked objects whose queue is still full
+		const size_t num = _parked.size();
+		for (size_t c = 0; c < num; ++c) {
+			ChunkedCompletion *completion = _parked.front();
+			_parked.pop_front();
+
+			if (completion->postNotification())
+				finished.push_back(completion);
+			else
+				_parked.push_back(completion);
+		}
+		_numParked.store(_parked.size(), std::memory_order_release);
+	}
+
+	// Release the task events outside the lock
+	for (ChunkedCompletion *completion : finished)
+		completion->finish();
+}
+
+} // namespace tagaspi
@@ -0,0 +1,136 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef CHUNKED_COMPLETION_HPP
+#define CHUNKED_COMPLETION_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Completion.hpp"
+#include "Environment.hpp"
+#include "TaskingModel.hpp"
+#include "util/ErrorHandler.hpp"
+#include "util/SpinLock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace tagaspi {
+
+//! Completion object of an operation split into chunks, such as striped
+//! transfers and split lists. It releases the task event once all chunks
+//! have completed, and posts the notification if needed
+//!
+//! The completion runs from the polling of the queue, so the notification
+//! cannot wait for space in that queue. If the queue is full, the object is
+//! parked and the polling retries the notification later
+class ChunkedCompletion : public Completion {
+private:
+	TaskingModel::task_handle_t _task;
+
+	bool _notify;
+	bool _failed;
+
+	gaspi_segment_id_t _segment;
+	gaspi_rank_t _rank;
+	gaspi_notification_id_t _notificationId;
+	gaspi_notification_t _notificationValue;
+	gaspi_queue_id_t _queue;
+
+	//! The objects whose notification is waiting for queue space
+	static std::deque<ChunkedCompletion *> _parked;
+
+	//! The lock protecting the parked objects
+	static SpinLock _parkedLock;
+
+	static std::atomic<uint64_t> _numParked;
+
+	//! \brief Try to post the notification without blocking
+	//!
+	//! \returns Whether the notification was posted
+	inline bool postNotification()
+	{
+		gaspi_return_t eret = gaspi_operation_submit(GASPI_OP_NOTIFY,
+					(gaspi_tag_t) _task, 0, 0, _rank, _segment, 0, 0,
+					_notificationId, _notificationValue,
+					_queue, GASPI_TEST);
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+			return false;
+
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when posting the notification of a chunked operation");
+		return true;
+	}
+
+	//! \brief Release the task event and the object
+	inline void finish()
+	{
+		TaskingModel::decreaseTaskEvents(_task, 1);
+
+		delete this;
+	}
+
+	inline void complete() override
+	{
+		if (_notify) {
+			if (_failed) {
+				gaspi_number_t numRequests = _env.numRequests[Operation::NOTIFY];
+				TaskingModel::decreaseTaskEvents(_task, numRequests);
+			} else if (!postNotification()) {
+				// All chunks landed, but the queue has no space
+				std::lock_guard<SpinLock> guard(_parkedLock);
+				_parked.push_back(this);
+				_numParked.fetch_add(1, std::memory_order_release);
+				return;
+			}
+		}
+		finish();
+	}
+
+public:
+	inline ChunkedCompletion(
+		uint64_t pending,
+		TaskingModel::task_handle_t task,
+		bool notify,
+		gaspi_segment_id_t segment,
+		gaspi_rank_t rank,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	) :
+		Completion(pending),
+		_task(task),
+		_notify(notify),
+		_failed(false),
+		_segment(segment),
+		_rank(rank),
+		_notificationId(notificationId),
+		_notificationValue(notificationValue),
+		_queue(queue)
+	{
+	}
+
+	//! \brief Mark the operation as failed to avoid posting the notification
+	inline void fail()
+	{
+		_failed = true;
+	}
+
+	//! \brief Post the parked notifications while there is queue space
+	static void progress();
+
+	static inline bool hasParked()
+	{
+		return _numParked.load(std::memory_order_acquire) > 0;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // CHUNKED_COMPLETION_HPP
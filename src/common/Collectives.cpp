@@ -0,0 +1,364 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Collectives.hpp"
+#include "Polling.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+#include "util/Utils.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <mutex>
+
+namespace tagaspi {
+
+bool Collectives::_enabled = false;
+gaspi_segment_id_t Collectives::_segment;
+char *Collectives::_segmentPtr = nullptr;
+gaspi_queue_id_t Collectives::_queue;
+gaspi_size_t Collectives::_chunkSize = 0;
+gaspi_number_t Collectives::_numSteps = 0;
+gaspi_size_t Collectives::_groupDataSize = 0;
+std::vector<Collectives::Group> Collectives::_groups;
+std::vector<std::deque<Collectives::CollectiveOperation *> > Collectives::_operations;
+uint64_t Collectives::_numOperations = 0;
+SpinLock Collectives::_lock;
+TaskingModel::PollingInstance *Collectives::_pollingInstance = nullptr;
+
+gaspi_return_t Collectives::enable(gaspi_segment_id_t segment, gaspi_queue_id_t queue)
+{
+	assert(!_enabled);
+
+	gaspi_number_t maxGroups;
+	gaspi_return_t eret = gaspi_group_max(&maxGroups);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_number_t numNotifications;
+	eret = gaspi_notification_num(&numNotifications);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	if (numNotifications < maxGroups * NotificationsPerGroup) {
+		fprintf(stderr, "Error: Not enough notifications for the collectives segment\n");
+		return GASPI_ERROR;
+	}
+
+	gaspi_rank_t numRanks;
+	eret = gaspi_proc_num(&numRanks);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_number_t numRounds = 0;
+	while (((gaspi_number_t) 1 << numRounds) < numRanks)
+		++numRounds;
+
+	// The TAGASPI_COLLECTIVES_CHUNK_SIZE envar determines the size in bytes
+	// of the chunks in which the collectives pipeline their data
+	EnvironmentVariable<gaspi_size_t> chunkSize("TAGASPI_COLLECTIVES_CHUNK_SIZE", 4096);
+	if (chunkSize.getValue() < sizeof(uint64_t) || chunkSize.getValue() % sizeof(uint64_t)) {
+		fprintf(stderr, "Error: The collectives chunk size must be a multiple of %zu bytes\n", sizeof(uint64_t));
+		return GASPI_ERROR;
+	}
+
+	_chunkSize = chunkSize;
+	_numSteps = numRounds + 2;
+
+	// The allreduce uses a sending and a receiving chunk per step and buffer,
+	// and the broadcast uses a chunk per buffer after them
+	_groupDataSize = (2 * _numSteps + 1) * NumBuffers * _chunkSize;
+
+	eret = gaspi_segment_create(segment, maxGroups * _groupDataSize,
+				GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_pointer_t pointer;
+	eret = gaspi_segment_ptr(segment, &pointer);
+	assert(eret == GASPI_SUCCESS);
+
+	_segment = segment;
+	_segmentPtr = (char *) pointer;
+	_queue = queue;
+	_groups.resize(maxGroups);
+	_operations.resize(maxGroups);
+	_numOperations = 0;
+
+	_enabled = true;
+
+	_pollingInstance = TaskingModel::registerPolling("TAGASPI COLLECTIVES", poll, nullptr);
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t Collectives::disable()
+{
+	assert(_enabled);
+
+	// Wait until the collectives in flight have finished
+	bool pending = true;
+	while (pending) {
+		{
+			std::lock_guard<SpinLock> guard(_lock);
+			pending = (_numOperations > 0);
+		}
+
+		if (pending) {
+			progress();
+			util::spinWait();
+		}
+	}
+
+	gaspi_return_t eret = gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	TaskingModel::unregisterPolling(_pollingInstance);
+	_pollingInstance = nullptr;
+
+	_enabled = false;
+
+	_groups.clear();
+	_operations.clear();
+	_segmentPtr = nullptr;
+
+	return gaspi_segment_delete(_segment);
+}
+
+gaspi_return_t Collectives::initializeGroup(gaspi_group_t group)
+{
+	assert(group < _groups.size());
+
+	Group &members = _groups[group];
+	if (members.initialized)
+		return GASPI_SUCCESS;
+
+	gaspi_rank_t rank;
+	gaspi_return_t eret = gaspi_proc_rank(&rank);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	gaspi_number_t size;
+	eret = gaspi_group_size(group, &size);
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	members.ranks.resize(size);
+	eret = gaspi_group_ranks(group, members.ranks.data());
+	if (eret != GASPI_SUCCESS)
+		return eret;
+
+	members.position = size;
+	for (gaspi_number_t m = 0; m < size; ++m) {
+		if (members.ranks[m] == rank)
+			members.position = m;
+	}
+
+	if (members.position == size) {
+		fprintf(stderr, "Error: Rank %d is not a member of group %d\n", rank, group);
+		return GASPI_ERROR;
+	}
+
+	// Nothing was received before the first sequence
+	members.received.assign(NotificationsPerGroup, SequenceMask);
+	members.initialized = true;
+
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t Collectives::start(CollectiveOperation *operation)
+{
+	assert(_enabled);
+	assert(operation != nullptr);
+
+	if (operation->group >= _groups.size()) {
+		fprintf(stderr, "Error: Group %d is not valid\n", operation->group);
+		return GASPI_ERROR;
+	}
+
+	{
+		std::lock_guard<SpinLock> guard(_lock);
+
+		gaspi_return_t eret = initializeGroup(operation->group);
+		if (eret != GASPI_SUCCESS)
+			return eret;
+
+		Group &members = _groups[operation->group];
+		operation->sequence = members.sequence;
+		members.sequence = (members.sequence + operation->numSequences) & SequenceMask;
+
+		_operations[operation->group].push_back(operation);
+		++_numOperations;
+	}
+
+	// Post the first notifications without waiting for the polling
+	progress();
+
+	return GASPI_SUCCESS;
+}
+
+bool Collectives::notify(
+	const CollectiveOperation &operation,
+	const Group &members,
+	gaspi_number_t member,
+	NotificationArea area,
+	gaspi_number_t index,
+	uint32_t sequence
+) {
+	assert(member < members.size());
+
+	// Notifications cannot carry a zero value
+	gaspi_return_t eret = gaspi_operation_submit(GASPI_OP_NOTIFY, GASPI_TAG_NULL,
+				0, 0, members.ranks[member], _segment, 0, 0,
+				getNotificationId(operation.group, area, index),
+				(sequence & SequenceMask) + 1, _queue, GASPI_TEST);
+	if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+		return false;
+
+	ErrorHandler::failIf(eret != GASPI_SUCCESS,
+		"Return code ", (int) eret, " when posting a notification of a collective");
+
+	return true;
+}
+
+bool Collectives::write(
+	const CollectiveOperation &operation,
+	const Group &members,
+	gaspi_number_t member,
+	gaspi_number_t chunkLocal,
+	gaspi_number_t chunkRemote,
+	gaspi_size_t size,
+	NotificationArea area,
+	gaspi_number_t index,
+	uint32_t sequence,
+	gaspi_tag_t tag
+) {
+	assert(member < members.size());
+	assert(size > 0 && size <= _chunkSize);
+
+	gaspi_return_t eret = gaspi_operation_submit(GASPI_OP_WRITE_NOTIFY, tag,
+				_segment, getChunkOffset(operation.group, chunkLocal), members.ranks[member],
+				_segment, getChunkOffset(operation.group, chunkRemote), size,
+				getNotificationId(operation.group, area, index),
+				(sequence & SequenceMask) + 1, _queue, GASPI_TEST);
+	if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+		return false;
+
+	ErrorHandler::failIf(eret != GASPI_SUCCESS,
+		"Return code ", (int) eret, " when writing a chunk of a collective");
+
+	return true;
+}
+
+void Collectives::receive(const CollectiveOperation &operation, Group &members, gaspi_number_t index)
+{
+	assert(index < members.received.size());
+
+	// A sequence is ahead if it is less than half the sequence space ahead
+	constexpr uint32_t Half = (SequenceMask >> 1) + 1;
+
+	gaspi_notification_t value;
+	gaspi_return_t eret = gaspi_notify_reset(_segment,
+				getNotificationId(operation.group, BARRIER_AREA, index), &value);
+	ErrorHandler::failIf(eret != GASPI_SUCCESS,
+		"Return code ", (int) eret, " when checking a notification of a collective");
+
+	if (value != 0) {
+		uint32_t &received = members.received[index];
+		const uint32_t last = value - 1;
+		const uint32_t advance = (last - received) & SequenceMask;
+		if (advance > 0 && advance < Half)
+			received = last;
+	}
+}
+
+void Collectives::catchUp(const CollectiveOperation &operation, Group &members)
+{
+	constexpr uint32_t Half = (SequenceMask >> 1) + 1;
+	constexpr uint32_t Quarter = Half >> 1;
+
+	const uint32_t previous = (operation.sequence - 1) & SequenceMask;
+
+	for (gaspi_number_t index = 0; index < members.received.size(); ++index) {
+		uint32_t &received = members.received[index];
+
+		const uint32_t ahead = (received - previous) & SequenceMask;
+		const uint32_t behind = (previous - received) & SequenceMask;
+		if (ahead < Half || behind < Quarter)
+			continue;
+
+		// Values of the skipped sequences are ignored; later ones are kept
+		received = previous;
+		receive(operation, members, index);
+	}
+}
+
+bool Collectives::arrived(
+	const CollectiveOperation &operation,
+	Group &members,
+	NotificationArea area,
+	gaspi_number_t index,
+	uint32_t sequence
+) {
+	assert(area + index < members.received.size());
+
+	// A sequence is reached if it is at most half the sequence space behind
+	constexpr uint32_t Half = (SequenceMask >> 1) + 1;
+
+	const uint32_t &received = members.received[area + index];
+	if (((received - sequence) & SequenceMask) < Half)
+		return true;
+
+	receive(operation, members, area + index);
+
+	return (((received - sequence) & SequenceMask) < Half);
+}
+
+void Collectives::progress()
+{
+	if (!_lock.trylock())
+		return;
+
+	for (size_t group = 0; _numOperations > 0 && group < _operations.size(); ++group) {
+		std::deque<CollectiveOperation *> &operations = _operations[group];
+
+		// The operations of a group progress in calling order
+		while (!operations.empty()) {
+			CollectiveOperation *operation = operations.front();
+			assert(operation != nullptr);
+
+			if (!operation->active) {
+				catchUp(*operation, _groups[group]);
+				operation->active = true;
+			}
+
+			if (!operation->progress(_groups[group]))
+				break;
+
+			operations.pop_front();
+			--_numOperations;
+
+			TaskingModel::decreaseTaskEvents(operation->task, 1);
+
+			delete operation;
+		}
+	}
+
+	_lock.unlock();
+}
+
+uint64_t Collectives::poll(void *)
+{
+	progress();
+
+	return Polling::getPeriod();
+}
+
+} // namespace tagaspi
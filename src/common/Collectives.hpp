@@ -0,0 +1,295 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef COLLECTIVES_HPP
+#define COLLECTIVES_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that runs the task-aware collective operations. The collectives
+//! exchange notifications and data on a dedicated segment, which is created
+//! on all ranks when the collectives are enabled. Each group owns a range
+//! of notification identifiers and a data area in the segment
+//!
+//! The collectives of a group must be called in the same order on all its
+//! ranks, and they progress one after the other through a polling instance.
+//! Each collective takes one or more consecutive sequence numbers of its
+//! group, one per chunk of data, which are carried by the notifications.
+//! Since notifications from a peer are posted in order on the same queue,
+//! the sequences received on a notification only grow; a notification
+//! overwritten by a later sequence still tells that the earlier one was
+//! posted. The sequences wrap around, so they are compared modulo 2^31
+//!
+//! The chunks of a collective are pipelined: the chunk s only starts once
+//! the chunk s - Window has finished on this rank. The data buffers of the
+//! chunk s are reused by the chunk s + NumBuffers. Thus, a peer reusing
+//! a buffer has received a later message from this rank that was posted
+//! after consuming the previous contents of the buffer
+class Collectives {
+public:
+	//! The maximum number of rounds of the logarithmic algorithms
+	static constexpr gaspi_number_t MaxRounds = 8 * sizeof(gaspi_rank_t);
+
+	//! The number of notification identifiers owned by each group
+	static constexpr gaspi_number_t NotificationsPerGroup = 16 * MaxRounds;
+
+	//! The maximum number of chunks of a collective in flight
+	static constexpr gaspi_number_t Window = 2;
+
+	//! The number of data buffers of each step of a collective
+	static constexpr gaspi_number_t NumBuffers = 2 * Window;
+
+	//! The first identifier of each kind of notification in a group
+	enum NotificationArea {
+		BARRIER_AREA = 0,
+		ALLREDUCE_AREA = BARRIER_AREA + MaxRounds,
+		BROADCAST_DATA_AREA = ALLREDUCE_AREA + (MaxRounds + 2) * NumBuffers,
+		BROADCAST_READY_AREA = BROADCAST_DATA_AREA + NumBuffers,
+		BROADCAST_ACK_AREA = BROADCAST_READY_AREA + MaxRounds,
+		END_AREA = BROADCAST_ACK_AREA + MaxRounds * NumBuffers,
+	};
+
+	static_assert(END_AREA <= NotificationsPerGroup, "Too many notifications per group");
+
+	//! The members of a group as seen by this rank
+	struct Group {
+		bool initialized;
+
+		//! The ranks of the group and the position of this rank
+		std::vector<gaspi_rank_t> ranks;
+		gaspi_number_t position;
+
+		//! The next sequence of the group
+		uint32_t sequence;
+
+		//! The last sequence received on each notification of the group
+		std::vector<uint32_t> received;
+
+		Group() :
+			initialized(false), ranks(), position(0), sequence(0), received()
+		{
+		}
+
+		inline gaspi_number_t size() const
+		{
+			return ranks.size();
+		}
+	};
+
+	//! Base class of the collective operations in flight
+	class CollectiveOperation {
+	public:
+		TaskingModel::task_handle_t task;
+		gaspi_group_t group;
+
+		//! The sequences of the operation; the first is assigned when started
+		uint32_t sequence;
+		uint32_t numSequences;
+
+		//! Whether the operation reached the head of its group
+		bool active;
+
+		inline CollectiveOperation(
+			TaskingModel::task_handle_t task,
+			gaspi_group_t group,
+			uint32_t numSequences = 1
+		) :
+			task(task), group(group), sequence(0), numSequences(numSequences), active(false)
+		{
+		}
+
+		virtual ~CollectiveOperation()
+		{
+		}
+
+		//! \brief Advance the operation as much as possible
+		//!
+		//! \param members The members of the group of the operation
+		//!
+		//! \returns Whether the operation has finished
+		virtual bool progress(Group &members) = 0;
+	};
+
+private:
+	//! The sequences are compared modulo 2^31
+	static constexpr uint32_t SequenceMask = 0x7fffffff;
+
+	static bool _enabled;
+
+	//! The segment of the collectives, its local address and the queue to post
+	static gaspi_segment_id_t _segment;
+	static char *_segmentPtr;
+	static gaspi_queue_id_t _queue;
+
+	//! The size of the data chunks and the steps of the logarithmic algorithms
+	static gaspi_size_t _chunkSize;
+	static gaspi_number_t _numSteps;
+
+	//! The size of the data area of each group
+	static gaspi_size_t _groupDataSize;
+
+	//! The groups indexed by their identifier
+	static std::vector<Group> _groups;
+
+	//! The operations of each group in calling order
+	static std::vector<std::deque<CollectiveOperation *> > _operations;
+
+	//! The total number of operations in flight
+	static uint64_t _numOperations;
+
+	//! The lock protecting the groups and their operations
+	static SpinLock _lock;
+
+	static TaskingModel::PollingInstance *_pollingInstance;
+
+	//! \brief Get the members of a group, retrieving them the first time
+	//!
+	//! The lock must be held by the caller
+	static gaspi_return_t initializeGroup(gaspi_group_t group);
+
+	//! \brief Read a notification of a group and advance its received sequence
+	static void receive(const CollectiveOperation &operation, Group &members, gaspi_number_t index);
+
+	//! \brief Catch up the notifications of a group that fell behind
+	//!
+	//! The notifications only advance when they get traffic, and some
+	//! of them may go unused for long. Once an operation reaches the head
+	//! of its group, no operation waits for the previous sequences, so the
+	//! notifications far behind are moved to the sequence before it. This
+	//! keeps them from falling half the sequence space behind, where they
+	//! would look ahead of the sequences of the group
+	static void catchUp(const CollectiveOperation &operation, Group &members);
+
+	//! \brief Advance the operations at the head of each group
+	static void progress();
+
+	static uint64_t poll(void *data);
+
+public:
+	static inline bool isEnabled()
+	{
+		return _enabled;
+	}
+
+	//! \brief Create the segment of the collectives and start them
+	//!
+	//! This function is collective over all ranks
+	static gaspi_return_t enable(gaspi_segment_id_t segment, gaspi_queue_id_t queue);
+
+	//! \brief Wait for the collectives in flight and release the segment
+	//!
+	//! This function is collective over all ranks
+	static gaspi_return_t disable();
+
+	//! \brief Start a collective operation on its group
+	//!
+	//! The operation is released once finished, which decreases a single
+	//! event of its task. The caller must have increased that event
+	static gaspi_return_t start(CollectiveOperation *operation);
+
+	//! \brief Get the queue where the collectives post their requests
+	static inline gaspi_queue_id_t getQueue()
+	{
+		return _queue;
+	}
+
+	//! \brief Get the size in bytes of the data chunks
+	static inline gaspi_size_t getChunkSize()
+	{
+		return _chunkSize;
+	}
+
+	//! \brief Get the number of steps of the logarithmic algorithms, which
+	//! are the rounds for the largest group plus two extra steps
+	static inline gaspi_number_t getNumSteps()
+	{
+		return _numSteps;
+	}
+
+	//! \brief Get the offset of a data chunk of a group in the segment
+	static inline gaspi_offset_t getChunkOffset(gaspi_group_t group, gaspi_number_t chunk)
+	{
+		assert((chunk + 1) * _chunkSize <= _groupDataSize);
+		return (gaspi_offset_t) group * _groupDataSize + chunk * _chunkSize;
+	}
+
+	//! \brief Get the local address of a data chunk of a group
+	static inline char *getChunk(gaspi_group_t group, gaspi_number_t chunk)
+	{
+		return _segmentPtr + getChunkOffset(group, chunk);
+	}
+
+	//! \brief Get the identifier of a notification of a group
+	static inline gaspi_notification_id_t getNotificationId(
+		gaspi_group_t group,
+		NotificationArea area,
+		gaspi_number_t index
+	) {
+		assert(area + index < NotificationsPerGroup);
+		return (gaspi_notification_id_t) group * NotificationsPerGroup + area + index;
+	}
+
+	//! \brief Post a notification to a member of the group of an operation
+	//!
+	//! \param sequence The sequence carried by the notification
+	//!
+	//! \returns Whether the notification was posted; otherwise, the
+	//!          queue was full and the caller must retry later
+	static bool notify(
+		const CollectiveOperation &operation,
+		const Group &members,
+		gaspi_number_t member,
+		NotificationArea area,
+		gaspi_number_t index,
+		uint32_t sequence
+	);
+
+	//! \brief Write a data chunk with notification to a member of the group
+	//! of an operation. The chunks are identified by their index in the data
+	//! area of the group, which is the same on all ranks
+	//!
+	//! \param tag The tag of the write, which is null unless the caller
+	//!            needs to know when its local buffer can be reused
+	//!
+	//! \returns Whether the write was posted; otherwise, the queue was
+	//!          full and the caller must retry later
+	static bool write(
+		const CollectiveOperation &operation,
+		const Group &members,
+		gaspi_number_t member,
+		gaspi_number_t chunkLocal,
+		gaspi_number_t chunkRemote,
+		gaspi_size_t size,
+		NotificationArea area,
+		gaspi_number_t index,
+		uint32_t sequence,
+		gaspi_tag_t tag = GASPI_TAG_NULL
+	);
+
+	//! \brief Check whether a notification of a group reached a sequence
+	static bool arrived(
+		const CollectiveOperation &operation,
+		Group &members,
+		NotificationArea area,
+		gaspi_number_t index,
+		uint32_t sequence
+	);
+};
+
+} // namespace tagaspi
+
+#endif // COLLECTIVES_HPP
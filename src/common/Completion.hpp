@@ -0,0 +1,112 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef COMPLETION_HPP
+#define COMPLETION_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "TaskingModel.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace tagaspi {
+
+//! Class that represents an internal completion object. The GASPI requests
+//! tagged with a completion object decrease its pending counter instead of
+//! the events of a task. Once all its requests have completed, the object
+//! runs its completion action. The tags of completion objects are told apart
+//! from task handles through their least significant bit, which is always
+//! clear in task handles
+class Completion {
+private:
+	static constexpr uintptr_t TagBit = 0x1;
+
+	//! The number of pending requests
+	std::atomic<uint64_t> _pending;
+
+protected:
+	//! \brief Action to run once all requests have completed
+	//!
+	//! The implementations are responsible for releasing the object
+	virtual void complete() = 0;
+
+public:
+	inline Completion(uint64_t pending) :
+		_pending(pending)
+	{
+		assert(((uintptr_t) this & TagBit) == 0);
+	}
+
+	virtual ~Completion()
+	{
+		assert(_pending.load() == 0);
+	}
+
+	//! \brief Increase the number of pending requests
+	inline void increase(uint64_t increment)
+	{
+		_pending.fetch_add(increment, std::memory_order_relaxed);
+	}
+
+	//! \brief Decrease the number of pending requests
+	//!
+	//! \returns Whether the object completed and was released
+	inline bool decrease(uint64_t decrement)
+	{
+		uint64_t pending = _pending.fetch_sub(decrement, std::memory_order_acq_rel);
+		assert(pending >= decrement);
+
+		if (pending == decrement) {
+			complete();
+			return true;
+		}
+		return false;
+	}
+
+	//! \brief Get the number of pending requests
+	inline uint64_t getPending() const
+	{
+		return _pending.load(std::memory_order_acquire);
+	}
+
+	//! \brief Get the tag for the requests bound to this object
+	inline gaspi_tag_t getTag() const
+	{
+		return (gaspi_tag_t) ((uintptr_t) this | TagBit);
+	}
+
+	//! \brief Process several completed requests given their tag
+	//!
+	//! \param tag The tag of the requests, which is either a task
+	//!            handle or a completion object tag
+	//! \param num The number of completed requests
+	static inline void requestsCompleted(gaspi_tag_t tag, uint64_t num)
+	{
+		assert(tag != GASPI_TAG_NULL);
+
+		if ((uintptr_t) tag & TagBit) {
+			Completion *completion = (Completion *) ((uintptr_t) tag & ~TagBit);
+			completion->decrease(num);
+		} else {
+			TaskingModel::task_handle_t task = (TaskingModel::task_handle_t) tag;
+			TaskingModel::decreaseTaskEvents(task, num);
+		}
+	}
+
+	//! \brief Process a completed request given its tag
+	static inline void requestCompleted(gaspi_tag_t tag)
+	{
+		requestsCompleted(tag, 1);
+	}
+};
+
+} // namespace tagaspi
+
+#endif // COMPLETION_HPP
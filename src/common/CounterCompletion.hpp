@@ -0,0 +1,60 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef COUNTER_COMPLETION_HPP
+#define COUNTER_COMPLETION_HPP
+
+#include "Completion.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace tagaspi {
+
+//! Completion object that only counts the requests in flight of its owner,
+//! which polls it to know when they have completed. The object can be
+//! reused once idle, and it is released by its owner
+class CounterCompletion : public Completion {
+private:
+	std::atomic<bool> _idle;
+
+	inline void complete() override
+	{
+		// This must be the last access to the object
+		_idle.store(true, std::memory_order_release);
+	}
+
+public:
+	inline CounterCompletion(uint64_t pending = 0) :
+		Completion(pending),
+		_idle(pending == 0)
+	{
+	}
+
+	//! \brief Account requests about to be posted
+	//!
+	//! The object must be idle, so the requests of a batch have to be
+	//! accounted at once before posting the first of them
+	inline void add(uint64_t requests)
+	{
+		assert(isIdle());
+		assert(requests > 0);
+
+		_idle.store(false, std::memory_order_relaxed);
+		increase(requests);
+	}
+
+	//! \brief Check whether all accounted requests have completed
+	inline bool isIdle() const
+	{
+		return _idle.load(std::memory_order_acquire);
+	}
+};
+
+} // namespace tagaspi
+
+#endif // COUNTER_COMPLETION_HPP
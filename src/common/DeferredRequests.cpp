@@ -0,0 +1,59 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include "DeferredRequests.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+std::deque<DeferredRequests::PendingRequest> DeferredRequests::_pending;
+SpinLock DeferredRequests::_pendingLock;
+std::atomic<uint64_t> DeferredRequests::_numPending(0);
+
+gaspi_return_t DeferredRequests::submit(const PendingRequest &operation)
+{
+	std::lock_guard<SpinLock> guard(_pendingLock);
+
+	// Keep the submission order of the parked operations
+	if (!_pending.empty()) {
+		_pending.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_release);
+		return GASPI_SUCCESS;
+	}
+
+	gaspi_return_t eret = post(operation);
+	if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL) {
+		_pending.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_release);
+		return GASPI_SUCCESS;
+	}
+	return eret;
+}
+
+void DeferredRequests::progress()
+{
+	if (!_pendingLock.trylock())
+		return;
+
+	while (!_pending.empty()) {
+		gaspi_return_t eret = post(_pending.front());
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+			break;
+
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when posting a deferred request");
+
+		_pending.pop_front();
+		_numPending.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	_pendingLock.unlock();
+}
+
+} // namespace tagaspi
@@ -0,0 +1,79 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef DEFERRED_REQUESTS_HPP
+#define DEFERRED_REQUESTS_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "util/SpinLock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+namespace tagaspi {
+
+//! Class that submits the operations followed by requests without waiting
+//! for queue space. These operations may be submitted from the polling,
+//! e.g., by coroutines resumed there, which could never drain a full queue.
+//! The operations that find no space are parked in submission order and
+//! posted by the polling instances as the queues drain
+class DeferredRequests {
+public:
+	//! An operation waiting for queue space
+	struct PendingRequest {
+		gaspi_operation_type_t type;
+		gaspi_tag_t tag;
+		gaspi_segment_id_t segmentLocal;
+		gaspi_offset_t offsetLocal;
+		gaspi_rank_t rank;
+		gaspi_segment_id_t segmentRemote;
+		gaspi_offset_t offsetRemote;
+		gaspi_size_t size;
+		gaspi_notification_id_t notificationId;
+		gaspi_notification_t notificationValue;
+		gaspi_queue_id_t queue;
+	};
+
+private:
+	//! The parked operations in submission order
+	static std::deque<PendingRequest> _pending;
+
+	//! The lock protecting the parked operations
+	static SpinLock _pendingLock;
+
+	static std::atomic<uint64_t> _numPending;
+
+	//! \brief Try to submit an operation without blocking
+	static inline gaspi_return_t post(const PendingRequest &operation)
+	{
+		return gaspi_operation_submit(operation.type, operation.tag,
+				operation.segmentLocal, operation.offsetLocal, operation.rank,
+				operation.segmentRemote, operation.offsetRemote, operation.size,
+				operation.notificationId, operation.notificationValue,
+				operation.queue, GASPI_TEST);
+	}
+
+public:
+	//! \brief Submit an operation or park it if its queue is full
+	//!
+	//! \returns The GASPI error of a direct submission or GASPI_SUCCESS
+	static gaspi_return_t submit(const PendingRequest &operation);
+
+	//! \brief Submit the parked operations while there is space in the queues
+	static void progress();
+
+	static inline bool hasPending()
+	{
+		return _numPending.load(std::memory_order_acquire) > 0;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // DEFERRED_REQUESTS_HPP
@@ -0,0 +1,65 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include "Detached.hpp"
+#include "Environment.hpp"
+
+#include <cassert>
+
+namespace tagaspi {
+
+Detached::QueueEpoch *Detached::_queues = nullptr;
+
+void Detached::initialize()
+{
+	assert(_queues == nullptr);
+	assert(_env.maxQueues > 0);
+
+	_queues = new QueueEpoch[_env.maxQueues];
+	assert(_queues != nullptr);
+
+	for (gaspi_number_t queue = 0; queue < _env.maxQueues; ++queue) {
+		_queues[queue].current = new Epoch(false);
+		assert(_queues[queue].current != nullptr);
+	}
+}
+
+void Detached::finalize()
+{
+	assert(_queues != nullptr);
+
+	// Close the open epochs; those with operations in flight are released
+	// once they complete, as long as the queues are still polled
+	for (gaspi_number_t queue = 0; queue < _env.maxQueues; ++queue)
+		_queues[queue].current->decrease(1);
+
+	delete [] _queues;
+	_queues = nullptr;
+}
+
+void Detached::fence(TaskingModel::task_handle_t task, gaspi_queue_id_t queue)
+{
+	assert(_queues != nullptr);
+	assert(queue < _env.maxQueues);
+
+	Epoch *next = new Epoch(true);
+	assert(next != nullptr);
+
+	// The event is released once the closed epoch completes
+	TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+	QueueEpoch &state = _queues[queue];
+	state.lock.lock();
+	Epoch *closed = state.current;
+	closed->addFence(task);
+	closed->setNext(next);
+	state.current = next;
+	state.lock.unlock();
+
+	closed->decrease(1);
+}
+
+} // namespace tagaspi
@@ -0,0 +1,122 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef DETACHED_HPP
+#define DETACHED_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Completion.hpp"
+#include "Environment.hpp"
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+#include "util/Utils.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that tracks the detached operations, which are not bound to any
+//! task. The detached operations of each queue are grouped in epochs, and
+//! a fence closes the current epoch of its queue. An epoch completes once
+//! all its requests and the previous epoch of the queue have completed,
+//! and then it releases the tasks that closed it
+class Detached {
+private:
+	//! Completion object of an epoch of detached operations
+	class Epoch : public Completion {
+	private:
+		//! The tasks waiting for the epoch
+		std::vector<TaskingModel::task_handle_t> _fences;
+
+		//! The next epoch of the queue, which waits for this one
+		Epoch *_next;
+
+		inline void complete() override
+		{
+			for (TaskingModel::task_handle_t task : _fences)
+				TaskingModel::decreaseTaskEvents(task, 1);
+
+			if (_next != nullptr)
+				_next->decrease(1);
+
+			delete this;
+		}
+
+	public:
+		//! \brief Create an epoch
+		//!
+		//! The epoch holds one pending request until closed, and another
+		//! one until the previous epoch completes, if there is any
+		inline Epoch(bool hasPrevious) :
+			Completion(hasPrevious ? 2 : 1),
+			_fences(),
+			_next(nullptr)
+		{
+		}
+
+		inline void addFence(TaskingModel::task_handle_t task)
+		{
+			_fences.push_back(task);
+		}
+
+		inline void setNext(Epoch *next)
+		{
+			assert(_next == nullptr);
+			_next = next;
+		}
+	};
+
+	//! The open epoch of a queue, padded to avoid false sharing
+	struct alignas(CACHELINE_SIZE) QueueEpoch {
+		SpinLock lock;
+		Epoch *current;
+
+		QueueEpoch() : lock(), current(nullptr)
+		{
+		}
+	};
+
+	//! The open epoch of each queue
+	static QueueEpoch *_queues;
+
+public:
+	static void initialize();
+
+	static void finalize();
+
+	//! \brief Account the requests of a detached operation
+	//!
+	//! \returns The completion object of the operation, whose tag must be
+	//!          used to submit it. The caller discounts the requests of the
+	//!          operation from the object if the submission fails
+	static inline Completion *acquire(gaspi_queue_id_t queue, gaspi_number_t numRequests)
+	{
+		assert(_queues != nullptr);
+		assert(queue < _env.maxQueues);
+
+		QueueEpoch &state = _queues[queue];
+		state.lock.lock();
+		Epoch *epoch = state.current;
+		epoch->increase(numRequests);
+		state.lock.unlock();
+
+		return epoch;
+	}
+
+	//! \brief Close the open epoch of a queue on behalf of a task
+	//!
+	//! An event of the task is released once all detached operations
+	//! previously issued on the queue have completed
+	static void fence(TaskingModel::task_handle_t task, gaspi_queue_id_t queue);
+};
+
+} // namespace tagaspi
+
+#endif // DETACHED_HPP
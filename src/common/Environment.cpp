@@ -7,13 +7,23 @@
 #include <GASPI.h>
 #include <GASPI_Lowlevel.h>
 
+#include "Aggregation.hpp"
 #include "Allocator.hpp"
+#include "Atomics.hpp"
+#include "Collectives.hpp"
+#include "Detached.hpp"
 #include "Environment.hpp"
+#include "FlowControl.hpp"
 #include "HardwareInfo.hpp"
+#include "OperationList.hpp"
+#include "Passive.hpp"
 #include "Polling.hpp"
+#include "StridedList.hpp"
 #include "TaskingModel.hpp"
 #include "WaitingRange.hpp"
+#include "util/EnvironmentVariable.hpp"
 #include "util/ErrorHandler.hpp"
+#include "util/RCU.hpp"
 #include "util/SpinLock.hpp"
 
 #include <cassert>
@@ -29,6 +39,15 @@ SpinLock ErrorHandler::_lock;
 std::vector<int> HardwareInfo::_cpuToNUMANode;
 std::vector<bool> HardwareInfo::_numaNodeAvailability;
 size_t HardwareInfo::_numAvailableNUMANodes;
+std::vector<int> HardwareInfo::_cpuToLLCDomain;
+size_t HardwareInfo::_numLLCDomains;
+
+std::atomic<util::RCU::Record *> util::RCU::_records(nullptr);
+std::atomic<uint64_t> util::RCU::_epoch(1);
+thread_local util::RCU::Record *util::RCU::_record = nullptr;
+
+thread_local OperationList::Buffers OperationList::_buffers;
+thread_local StridedList::Cache StridedList::_cache;
 
 void Environment::initialize()
 {
@@ -38,8 +57,10 @@ void Environment::initialize()
 	TaskingModel::initialize();
 
 	gaspi_queue_max(&_env.maxQueues);
+	gaspi_queue_size_max(&_env.queueSizeMax);
 	gaspi_segment_max(&_env.maxSegments);
 	assert(_env.maxQueues > 0);
+	assert(_env.queueSizeMax > 0);
 	assert(_env.maxSegments > 0);
 
 	_env.waitingRangeQueues = new WaitingRangeQueue[_env.maxSegments];
@@ -48,26 +69,52 @@ void Environment::initialize()
 	_env.waitingRangeLists = new WaitingRangeList[_env.maxSegments];
 	assert(_env.waitingRangeLists != nullptr);
 
-	_env.maxQueueGroups = MaxQueueGroups;
-	_env.numQueueGroups = 0;
+	_env.maxQueueGroups = QueueGroupTable::capacity();
 
 	gaspi_operation_get_num_requests(GASPI_OP_READ, 1, &_env.numRequests[Operation::READ]);
 	gaspi_operation_get_num_requests(GASPI_OP_WRITE, 1, &_env.numRequests[Operation::WRITE]);
 	gaspi_operation_get_num_requests(GASPI_OP_NOTIFY, 1, &_env.numRequests[Operation::NOTIFY]);
 	gaspi_operation_get_num_requests(GASPI_OP_WRITE_NOTIFY, 1, &_env.numRequests[Operation::WRITE_NOTIFY]);
 
-	_env.queueGroups = new QueueGroup*[_env.maxQueueGroups]();
-	assert(_env.queueGroups != nullptr);
+	// The TAGASPI_STRIPING_MIN_CHUNK_SIZE envar determines the minimum size
+	// in bytes of the chunks of striped operations. By default, 64 KiB
+	EnvironmentVariable<gaspi_size_t> stripingMinChunkSize("TAGASPI_STRIPING_MIN_CHUNK_SIZE", 64 * 1024);
+	_env.stripingMinChunkSize = stripingMinChunkSize;
+
+	// The TAGASPI_LIST_COALESCING envar determines whether the contiguous
+	// entries of list operations are merged. Disabled by default
+	EnvironmentVariable<bool> listCoalescing("TAGASPI_LIST_COALESCING", false);
+	_env.listCoalescing = listCoalescing;
+
+	// The TAGASPI_PACKING_THRESHOLD envar determines the size in bytes of
+	// the contiguous blocks below which packed transfers pack the data
+	EnvironmentVariable<gaspi_size_t> packingThreshold("TAGASPI_PACKING_THRESHOLD", 1024);
+	_env.packingThreshold = packingThreshold;
+
+	// The TAGASPI_EXCHANGE_CHUNK_SIZE envar determines the size in bytes of
+	// the chunks in which the exchange collectives split each block
+	EnvironmentVariable<gaspi_size_t> exchangeChunkSize("TAGASPI_EXCHANGE_CHUNK_SIZE", 256 * 1024);
+	_env.exchangeChunkSize = exchangeChunkSize;
+	ErrorHandler::failIf(_env.exchangeChunkSize == 0,
+		"The exchange chunk size cannot be zero");
 
 	_env.queuePollingLocks = new SpinLock[_env.maxQueues];
 	assert(_env.queuePollingLocks != nullptr);
 
 	Allocator<WaitingRange>::initialize();
 
+	FlowControl::initialize();
+
+	Detached::initialize();
+
 	_env.enabled = true;
 	std::atomic_thread_fence(std::memory_order_seq_cst);
 
 	Polling::initialize();
+
+	Atomics::initialize();
+
+	Passive::initialize();
 }
 
 void Environment::finalize()
@@ -76,16 +123,31 @@ void Environment::finalize()
 	assert(_env.queuePollingLocks != nullptr);
 	assert(_env.waitingRangeQueues != nullptr);
 	assert(_env.waitingRangeLists != NULL);
-	assert(_env.queueGroups != NULL);
+
+	// Both this and the termination are collective
+	if (Aggregation::isEnabled())
+		Aggregation::disable();
+
+	if (Collectives::isEnabled())
+		Collectives::disable();
+
+	Passive::finalize();
+
+	Atomics::finalize();
+
+	Detached::finalize();
 
 	Polling::finalize();
 
+	FlowControl::finalize();
+
 	Allocator<WaitingRange>::finalize();
 
 	delete [] _env.queuePollingLocks;
 	delete [] _env.waitingRangeQueues;
 	delete [] _env.waitingRangeLists;
-	delete [] _env.queueGroups;
+
+	_env.queueGroups.clear();
 
 	_env.enabled = false;
 	std::atomic_thread_fence(std::memory_order_seq_cst);
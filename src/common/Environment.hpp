@@ -12,6 +12,7 @@
 #include "WaitingRangeList.hpp"
 #include "WaitingRangeQueue.hpp"
 #include "QueueGroup.hpp"
+#include "QueueGroupTable.hpp"
 #include "util/SpinLock.hpp"
 
 namespace tagaspi {
@@ -26,37 +27,41 @@ enum Operation {
 
 class Environment {
 public:
-	static constexpr int MaxQueueGroups = 16;
-
 	bool enabled;
 
 	gaspi_number_t maxQueues;
+	gaspi_number_t queueSizeMax;
 	gaspi_number_t maxSegments;
 	gaspi_number_t maxQueueGroups;
-	gaspi_number_t numQueueGroups;
 	gaspi_number_t numRequests[Operation::NUM_OPERATIONS];
+	gaspi_size_t stripingMinChunkSize;
+	bool listCoalescing;
+	gaspi_size_t packingThreshold;
+	gaspi_size_t exchangeChunkSize;
 
 	WaitingRangeQueue *waitingRangeQueues;
 	WaitingRangeList *waitingRangeLists;
-	QueueGroup **queueGroups;
+	QueueGroupTable queueGroups;
 
 	SpinLock *queuePollingLocks;
 	SpinLock notificationPollingLock;
-	SpinLock queueGroupsLock;
 
 	Environment() :
 		enabled(false),
 		maxQueues(0),
+		queueSizeMax(0),
 		maxSegments(0),
 		maxQueueGroups(0),
-		numQueueGroups(0),
 		numRequests(),
+		stripingMinChunkSize(0),
+		listCoalescing(false),
+		packingThreshold(0),
+		exchangeChunkSize(0),
 		waitingRangeQueues(nullptr),
 		waitingRangeLists(nullptr),
-		queueGroups(nullptr),
+		queueGroups(),
 		queuePollingLocks(nullptr),
-		notificationPollingLock(),
-		queueGroupsLock()
+		notificationPollingLock()
 	{
 	}
 
@@ -0,0 +1,234 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef EXCHANGE_HPP
+#define EXCHANGE_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Collectives.hpp"
+#include "CounterCompletion.hpp"
+#include "Environment.hpp"
+#include "TaskingModel.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace tagaspi {
+
+//! Collective operation that writes a block of the local segment to each
+//! of its peers, such as an alltoallv or a sparse neighbour exchange. The
+//! blocks land directly on the segments of the peers, and each block posts
+//! a notification once all its data is there. Thus, the consumers of each
+//! block can wait for its notification instead of the whole exchange
+//!
+//! The peers are visited in a rotated order starting from this rank, so
+//! each rank targets a different peer at a time. Only a few peers are
+//! active at a time, and each active peer has a bounded number of chunks
+//! in flight. The operation finishes once all local writes have completed
+class ExchangeOperation : public Collectives::CollectiveOperation {
+public:
+	//! The maximum number of peers receiving chunks at a time
+	static constexpr size_t MaxActivePeers = 8;
+
+	//! The maximum number of chunks in flight to each peer
+	static constexpr gaspi_number_t MaxChunksPerPeer = Collectives::Window;
+
+	//! A block to write to a peer
+	struct Block {
+		//! The peer, which is a member of the group or a rank
+		gaspi_rank_t peer;
+
+		gaspi_offset_t offsetLocal;
+		gaspi_offset_t offsetRemote;
+		gaspi_size_t size;
+
+		//! The notification to post on the peer; for members, the first
+		//! notification, which is offset by the position of this rank
+		gaspi_notification_id_t notificationId;
+	};
+
+private:
+	//! The progress of a block
+	struct BlockState {
+		Block block;
+		gaspi_rank_t rank;
+
+		//! The bytes and requests posted so far and the total requests
+		gaspi_size_t posted;
+		uint64_t postedRequests;
+		uint64_t totalRequests;
+
+		CounterCompletion *completion;
+	};
+
+	gaspi_segment_id_t _segmentLocal;
+	gaspi_segment_id_t _segmentRemote;
+	gaspi_notification_t _notificationValue;
+
+	//! Whether the peers are members of the group instead of ranks
+	bool _byMember;
+
+	//! The blocks in visiting order
+	std::vector<BlockState> _blocks;
+	bool _initialized;
+
+	//! The oldest unfinished block
+	size_t _first;
+
+	//! \brief Get the number of requests of a chunk
+	static inline uint64_t getChunkRequests(gaspi_size_t offset, gaspi_size_t size)
+	{
+		if (size == 0)
+			return _env.numRequests[Operation::NOTIFY];
+		if (offset + _env.exchangeChunkSize >= size)
+			return _env.numRequests[Operation::WRITE_NOTIFY];
+		return _env.numRequests[Operation::WRITE];
+	}
+
+	//! \brief Resolve the ranks of the peers and sort the blocks
+	inline void initialize(const Collectives::Group &members)
+	{
+		const gaspi_rank_t self = (_byMember) ? members.position : members.ranks[members.position];
+
+		for (BlockState &state : _blocks) {
+			if (_byMember) {
+				state.rank = members.ranks[state.block.peer];
+				state.block.notificationId += members.position;
+			} else {
+				state.rank = state.block.peer;
+			}
+
+			uint64_t requests = 0;
+			gaspi_size_t offset = 0;
+			do {
+				requests += getChunkRequests(offset, state.block.size);
+				offset += _env.exchangeChunkSize;
+			} while (offset < state.block.size);
+
+			state.totalRequests = requests;
+			state.completion = new CounterCompletion(requests);
+			assert(state.completion != nullptr);
+		}
+
+		// Visit the peers after this rank first and wrap around
+		std::stable_sort(_blocks.begin(), _blocks.end(),
+			[self](const BlockState &a, const BlockState &b) {
+				const bool aBefore = (a.block.peer < self);
+				const bool bBefore = (b.block.peer < self);
+				if (aBefore != bBefore)
+					return bBefore;
+				return (a.block.peer < b.block.peer);
+			});
+
+		_initialized = true;
+	}
+
+	//! \brief Post the chunks of a block that fit in its window
+	//!
+	//! \returns Whether all chunks of the block were posted
+	inline bool postBlock(BlockState &state)
+	{
+		const Block &block = state.block;
+		const gaspi_size_t chunkSize = _env.exchangeChunkSize;
+		const uint64_t maxRequests = MaxChunksPerPeer * _env.numRequests[Operation::WRITE_NOTIFY];
+
+		while (state.postedRequests < state.totalRequests) {
+			const uint64_t completed = state.totalRequests - state.completion->getPending();
+			if (state.postedRequests - completed >= maxRequests)
+				return false;
+
+			const gaspi_size_t size = std::min(chunkSize, block.size - state.posted);
+			const bool last = (state.posted + size == block.size);
+
+			gaspi_operation_type_t type = GASPI_OP_WRITE;
+			if (block.size == 0)
+				type = GASPI_OP_NOTIFY;
+			else if (last)
+				type = GASPI_OP_WRITE_NOTIFY;
+
+			// The notification follows the previous chunks on the same queue
+			gaspi_return_t eret = gaspi_operation_submit(type, state.completion->getTag(),
+						_segmentLocal, block.offsetLocal + state.posted, state.rank,
+						_segmentRemote, block.offsetRemote + state.posted, size,
+						block.notificationId, _notificationValue,
+						Collectives::getQueue(), GASPI_TEST);
+			if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+				return false;
+
+			ErrorHandler::failIf(eret != GASPI_SUCCESS,
+				"Return code ", (int) eret, " when writing a block of an exchange");
+
+			state.postedRequests += getChunkRequests(state.posted, block.size);
+			state.posted += size;
+		}
+		return true;
+	}
+
+public:
+	inline ExchangeOperation(
+		TaskingModel::task_handle_t task,
+		gaspi_group_t group,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_notification_t notificationValue,
+		bool byMember,
+		std::vector<Block> &&blocks
+	) :
+		CollectiveOperation(task, group, 0),
+		_segmentLocal(segmentLocal),
+		_segmentRemote(segmentRemote),
+		_notificationValue(notificationValue),
+		_byMember(byMember),
+		_blocks(),
+		_initialized(false),
+		_first(0)
+	{
+		assert(notificationValue != 0);
+
+		_blocks.resize(blocks.size());
+		for (size_t b = 0; b < blocks.size(); ++b) {
+			_blocks[b].block = blocks[b];
+			_blocks[b].rank = 0;
+			_blocks[b].posted = 0;
+			_blocks[b].postedRequests = 0;
+			_blocks[b].totalRequests = 0;
+			_blocks[b].completion = nullptr;
+		}
+	}
+
+	inline ~ExchangeOperation()
+	{
+		for (BlockState &state : _blocks)
+			delete state.completion;
+	}
+
+	inline bool progress(Collectives::Group &members) override
+	{
+		if (!_initialized)
+			initialize(members);
+
+		// Retire the blocks whose writes have completed in order
+		while (_first < _blocks.size() && _blocks[_first].completion->isIdle())
+			++_first;
+
+		const size_t end = std::min(_blocks.size(), _first + MaxActivePeers);
+		for (size_t b = _first; b < end; ++b) {
+			BlockState &state = _blocks[b];
+			if (state.postedRequests < state.totalRequests)
+				postBlock(state);
+		}
+
+		return (_first == _blocks.size());
+	}
+};
+
+} // namespace tagaspi
+
+#endif // EXCHANGE_HPP
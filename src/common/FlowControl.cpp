@@ -0,0 +1,172 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "FlowControl.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+FlowControl::RankCredits *FlowControl::_ranks = nullptr;
+gaspi_rank_t FlowControl::_numRanks = 0;
+std::vector<std::deque<FlowControl::PendingOperation *> > FlowControl::_pending;
+SpinLock FlowControl::_pendingLock;
+std::atomic<uint64_t> FlowControl::_numPending(0);
+
+void FlowControl::initialize()
+{
+	assert(_ranks == nullptr);
+
+	// The TAGASPI_RANK_CREDITS envar determines the maximum number of
+	// in-flight operations targeting each rank. Disabled by default
+	EnvironmentVariable<uint64_t> rankCredits("TAGASPI_RANK_CREDITS", 0);
+	if (rankCredits.getValue() == 0)
+		return;
+
+	gaspi_return_t eret = gaspi_proc_num(&_numRanks);
+	ErrorHandler::failIf(eret != GASPI_SUCCESS,
+		"Return code ", (int) eret, " from gaspi_proc_num");
+	assert(_numRanks > 0);
+
+	_ranks = new RankCredits[_numRanks];
+	assert(_ranks != nullptr);
+
+	for (gaspi_rank_t rank = 0; rank < _numRanks; ++rank) {
+		_ranks[rank].credits.store(rankCredits.getValue(), std::memory_order_relaxed);
+	}
+
+	_pending.resize(_numRanks);
+
+	Allocator<CreditCompletion>::initialize();
+}
+
+void FlowControl::finalize()
+{
+	if (_ranks == nullptr)
+		return;
+
+	assert(_numPending.load() == 0);
+
+	delete [] _ranks;
+	_ranks = nullptr;
+	_numRanks = 0;
+
+	Allocator<CreditCompletion>::finalize();
+
+	_pending.clear();
+}
+
+gaspi_return_t FlowControl::post(const PendingOperation *operation, gaspi_timeout_t timeout)
+{
+	assert(operation != nullptr);
+
+	gaspi_tag_t tag = operation->completion->getTag();
+
+	if (!operation->isList) {
+		return gaspi_operation_submit(operation->type, tag,
+					operation->segmentLocal, operation->offsetLocal, operation->rank,
+					operation->segmentRemote, operation->offsetRemote, operation->size,
+					operation->notificationId, operation->notificationValue,
+					operation->queue, timeout);
+	}
+
+	// The lists of GASPI are not constant although they are not modified
+	PendingOperation *list = const_cast<PendingOperation *>(operation);
+
+	return gaspi_operation_list_submit(list->type, tag,
+				list->sizes.size(), list->segmentsLocal.data(), list->offsetsLocal.data(),
+				list->rank, list->segmentsRemote.data(), list->offsetsRemote.data(),
+				list->sizes.data(), list->segmentNotification,
+				list->notificationId, list->notificationValue,
+				list->queue, timeout);
+}
+
+gaspi_return_t FlowControl::park(PendingOperation *operation)
+{
+	assert(operation != nullptr);
+	assert(operation->rank < _numRanks);
+
+	const gaspi_rank_t rank = operation->rank;
+	RankCredits &ranks = _ranks[rank];
+
+	std::lock_guard<SpinLock> guard(_pendingLock);
+
+	_pending[rank].push_back(operation);
+	ranks.numPending.fetch_add(1, std::memory_order_release);
+	_numPending.fetch_add(1, std::memory_order_release);
+
+	// A credit may have been returned before parking the operation
+	drain(rank);
+
+	return GASPI_SUCCESS;
+}
+
+void FlowControl::drain(gaspi_rank_t rank)
+{
+	std::deque<PendingOperation *> &pending = _pending[rank];
+	RankCredits &ranks = _ranks[rank];
+
+	while (!pending.empty() && acquire(rank)) {
+		PendingOperation *operation = pending.front();
+		assert(operation != nullptr);
+
+		// Never block the polling instances on a full queue
+		gaspi_return_t eret = post(operation, GASPI_TEST);
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL) {
+			ranks.credits.fetch_add(1, std::memory_order_release);
+			break;
+		}
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when posting a deferred operation");
+
+		pending.pop_front();
+		ranks.numPending.fetch_sub(1, std::memory_order_relaxed);
+		_numPending.fetch_sub(1, std::memory_order_relaxed);
+
+		delete operation;
+	}
+}
+
+void FlowControl::release(gaspi_rank_t rank)
+{
+	assert(rank < _numRanks);
+
+	RankCredits &ranks = _ranks[rank];
+	ranks.credits.fetch_add(1, std::memory_order_release);
+
+	if (ranks.numPending.load(std::memory_order_acquire) == 0)
+		return;
+
+	// Otherwise, the next progress call will submit them
+	if (_pendingLock.trylock()) {
+		drain(rank);
+		_pendingLock.unlock();
+	}
+}
+
+void FlowControl::progress()
+{
+	if (_numPending.load(std::memory_order_acquire) == 0)
+		return;
+
+	if (!_pendingLock.trylock())
+		return;
+
+	for (gaspi_rank_t rank = 0; rank < _numRanks; ++rank) {
+		if (!_pending[rank].empty())
+			drain(rank);
+	}
+
+	_pendingLock.unlock();
+}
+
+} // namespace tagaspi
@@ -0,0 +1,341 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef FLOW_CONTROL_HPP
+#define FLOW_CONTROL_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Allocator.hpp"
+#include "Completion.hpp"
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+#include "util/Utils.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that limits the number of in-flight operations targeting each
+//! destination rank. Each operation consumes a credit of its rank, which
+//! is returned when all its requests complete. The operations that find
+//! no credits are parked in a per-rank pending list and submitted by the
+//! polling instances, in order, as the credits of the rank come back
+//!
+//! Striped operations and split lists are exempt and do not consume the
+//! credits of their rank
+class FlowControl {
+private:
+	//! Completion object of a flow-controlled operation
+	class CreditCompletion : public Completion {
+	private:
+		//! The tag of the task or completion object that owns the requests
+		gaspi_tag_t _tag;
+		gaspi_number_t _numRequests;
+		gaspi_rank_t _rank;
+		bool _failed;
+
+		//! Whether the object comes from the pool instead of the heap
+		bool _pooled;
+
+		inline void complete() override
+		{
+			if (!_failed)
+				Completion::requestsCompleted(_tag, _numRequests);
+
+			FlowControl::release(_rank);
+
+			if (_pooled)
+				Allocator<CreditCompletion>::free(this);
+			else
+				delete this;
+		}
+
+	public:
+		inline CreditCompletion(
+			gaspi_tag_t tag,
+			gaspi_number_t numRequests,
+			gaspi_rank_t rank
+		) :
+			Completion(numRequests),
+			_tag(tag),
+			_numRequests(numRequests),
+			_rank(rank),
+			_failed(false),
+			_pooled(false)
+		{
+		}
+
+		//! \brief Mark the operation as failed; the caller undoes the events
+		inline void fail()
+		{
+			_failed = true;
+		}
+
+		//! \brief Allocate an object of a direct submission
+		//!
+		//! The pool is only used if it has free entries, so that the
+		//! submission never waits for the completion of others
+		static inline CreditCompletion *allocate(
+			gaspi_tag_t tag,
+			gaspi_number_t numRequests,
+			gaspi_rank_t rank
+		) {
+			CreditCompletion *completion =
+				Allocator<CreditCompletion>::tryAllocate(tag, numRequests, rank);
+			if (completion != nullptr) {
+				completion->_pooled = true;
+				return completion;
+			}
+			return new CreditCompletion(tag, numRequests, rank);
+		}
+	};
+
+	//! An operation waiting for a credit of its destination rank
+	struct PendingOperation {
+		gaspi_operation_type_t type;
+		CreditCompletion *completion;
+		gaspi_rank_t rank;
+		gaspi_queue_id_t queue;
+		bool isList;
+
+		// Arguments of single operations
+		gaspi_segment_id_t segmentLocal;
+		gaspi_offset_t offsetLocal;
+		gaspi_segment_id_t segmentRemote;
+		gaspi_offset_t offsetRemote;
+		gaspi_size_t size;
+
+		// Arguments of list operations, copied from the caller
+		std::vector<gaspi_segment_id_t> segmentsLocal;
+		std::vector<gaspi_offset_t> offsetsLocal;
+		std::vector<gaspi_segment_id_t> segmentsRemote;
+		std::vector<gaspi_offset_t> offsetsRemote;
+		std::vector<gaspi_size_t> sizes;
+
+		gaspi_segment_id_t segmentNotification;
+		gaspi_notification_id_t notificationId;
+		gaspi_notification_t notificationValue;
+	};
+
+	//! The credits of a rank, padded to avoid false sharing
+	struct alignas(CACHELINE_SIZE) RankCredits {
+		//! The available credits
+		std::atomic<int64_t> credits;
+
+		//! The number of parked operations
+		std::atomic<uint64_t> numPending;
+
+		RankCredits() : credits(0), numPending(0)
+		{
+		}
+	};
+
+	//! The credits of each rank or nullptr if flow control is disabled
+	static RankCredits *_ranks;
+
+	//! The number of ranks
+	static gaspi_rank_t _numRanks;
+
+	//! The parked operations of each rank
+	static std::vector<std::deque<PendingOperation *> > _pending;
+
+	//! The lock protecting the pending lists
+	static SpinLock _pendingLock;
+
+	//! The total number of parked operations
+	static std::atomic<uint64_t> _numPending;
+
+	//! \brief Try to take a credit of a rank
+	static inline bool acquire(gaspi_rank_t rank)
+	{
+		std::atomic<int64_t> &credits = _ranks[rank].credits;
+
+		int64_t available = credits.load(std::memory_order_relaxed);
+		while (available > 0) {
+			if (credits.compare_exchange_weak(available, available - 1,
+					std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+		}
+		return false;
+	}
+
+	//! \brief Return a credit of a rank and submit its parked operations
+	static void release(gaspi_rank_t rank);
+
+	//! \brief Try to take a credit to submit an operation right away
+	//!
+	//! The credits are skipped when other operations to the same rank are
+	//! already waiting, to keep the order of the operations
+	static inline bool acquireDirect(gaspi_rank_t rank)
+	{
+		assert(rank < _numRanks);
+
+		return (_ranks[rank].numPending.load(std::memory_order_acquire) == 0 && acquire(rank));
+	}
+
+	//! \brief Handle the result of a direct submission
+	//!
+	//! The caller undoes the task events if the submission failed.
+	//! Completing the object returns the credit of the rank
+	static inline gaspi_return_t submitted(gaspi_return_t eret,
+		CreditCompletion *completion, gaspi_number_t numRequests)
+	{
+		assert(eret != GASPI_TIMEOUT);
+
+		if (eret != GASPI_SUCCESS) {
+			completion->fail();
+			completion->decrease(numRequests);
+		}
+		return eret;
+	}
+
+	//! \brief Park an operation that found no credits
+	static gaspi_return_t park(PendingOperation *operation);
+
+	//! \brief Submit the parked operations of a rank while there are credits
+	//!
+	//! The pending lock must be held by the caller
+	static void drain(gaspi_rank_t rank);
+
+	//! \brief Submit an operation to GASPI
+	static gaspi_return_t post(const PendingOperation *operation, gaspi_timeout_t timeout);
+
+public:
+	//! \brief Initialize the flow control from the TAGASPI_RANK_CREDITS envar
+	static void initialize();
+
+	static void finalize();
+
+	static inline bool isEnabled()
+	{
+		return (_ranks != nullptr);
+	}
+
+	//! \brief Submit the parked operations of all ranks while there are credits
+	static void progress();
+
+	//! \brief Submit a single operation under flow control
+	//!
+	//! The operation is either submitted or parked. The tag is either a
+	//! task, whose events the caller must have increased by the operation
+	//! requests, or a completion object accounting them. Only parked
+	//! operations allocate their descriptor, and the completion objects
+	//! of parked operations come from the heap
+	//!
+	//! \returns The GASPI error of a direct submission or GASPI_SUCCESS
+	static inline gaspi_return_t submit(
+		gaspi_tag_t tag,
+		gaspi_number_t numRequests,
+		gaspi_operation_type_t type,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	) {
+		if (acquireDirect(rank)) {
+			CreditCompletion *completion = CreditCompletion::allocate(tag, numRequests, rank);
+			assert(completion != nullptr);
+
+			gaspi_return_t eret = gaspi_operation_submit(type, completion->getTag(),
+						segmentLocal, offsetLocal, rank,
+						segmentRemote, offsetRemote, size,
+						notificationId, notificationValue,
+						queue, GASPI_BLOCK);
+			return submitted(eret, completion, numRequests);
+		}
+
+		// Parked operations may wait long for credits, so they never hold
+		// entries of the pool
+		PendingOperation *operation = new PendingOperation();
+		assert(operation != nullptr);
+
+		operation->type = type;
+		operation->completion = new CreditCompletion(tag, numRequests, rank);
+		assert(operation->completion != nullptr);
+		operation->rank = rank;
+		operation->queue = queue;
+		operation->isList = false;
+		operation->segmentLocal = segmentLocal;
+		operation->offsetLocal = offsetLocal;
+		operation->segmentRemote = segmentRemote;
+		operation->offsetRemote = offsetRemote;
+		operation->size = size;
+		operation->segmentNotification = segmentRemote;
+		operation->notificationId = notificationId;
+		operation->notificationValue = notificationValue;
+
+		return park(operation);
+	}
+
+	//! \brief Submit a list operation under flow control
+	//!
+	//! The descriptor arrays are only copied if the operation is parked
+	static inline gaspi_return_t submitList(
+		gaspi_tag_t tag,
+		gaspi_number_t numRequests,
+		gaspi_operation_type_t type,
+		gaspi_number_t num,
+		gaspi_segment_id_t * const segmentLocal,
+		gaspi_offset_t * const offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t * const segmentRemote,
+		gaspi_offset_t * const offsetRemote,
+		gaspi_size_t * const size,
+		gaspi_segment_id_t segmentNotification,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	) {
+		if (acquireDirect(rank)) {
+			CreditCompletion *completion = CreditCompletion::allocate(tag, numRequests, rank);
+			assert(completion != nullptr);
+
+			gaspi_return_t eret = gaspi_operation_list_submit(type, completion->getTag(),
+						num, segmentLocal, offsetLocal, rank,
+						segmentRemote, offsetRemote, size,
+						segmentNotification, notificationId, notificationValue,
+						queue, GASPI_BLOCK);
+			return submitted(eret, completion, numRequests);
+		}
+
+		// Parked operations may wait long for credits, so they never hold
+		// entries of the pool
+		PendingOperation *operation = new PendingOperation();
+		assert(operation != nullptr);
+
+		operation->type = type;
+		operation->completion = new CreditCompletion(tag, numRequests, rank);
+		assert(operation->completion != nullptr);
+		operation->rank = rank;
+		operation->queue = queue;
+		operation->isList = true;
+		operation->segmentsLocal.assign(segmentLocal, segmentLocal + num);
+		operation->offsetsLocal.assign(offsetLocal, offsetLocal + num);
+		operation->segmentsRemote.assign(segmentRemote, segmentRemote + num);
+		operation->offsetsRemote.assign(offsetRemote, offsetRemote + num);
+		operation->sizes.assign(size, size + num);
+		operation->segmentNotification = segmentNotification;
+		operation->notificationId = notificationId;
+		operation->notificationValue = notificationValue;
+
+		return park(operation);
+	}
+};
+
+} // namespace tagaspi
+
+#endif // FLOW_CONTROL_HPP
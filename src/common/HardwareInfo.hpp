@@ -8,6 +8,10 @@
 #define HARDWARE_INFO_HPP
 
 #include <cassert>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <numa.h>
@@ -20,9 +24,86 @@ private:
 	static std::vector<int> _cpuToNUMANode;
 	static std::vector<bool> _numaNodeAvailability;
 	static size_t _numAvailableNUMANodes;
+	static std::vector<int> _cpuToLLCDomain;
+	static size_t _numLLCDomains;
 
 	HardwareInfo() = delete;
 
+	//! \brief Get the first CPU sharing the last-level cache with a CPU
+	//!
+	//! \param cpu The system id of the CPU
+	//!
+	//! \returns The system id of the first CPU or -1 if the cache
+	//!          topology is not available
+	static inline int getLLCLeader(size_t cpu)
+	{
+		const std::string cpuPath = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index";
+
+		int leader = -1;
+		int maxLevel = -1;
+		for (int index = 0; ; ++index) {
+			const std::string path = cpuPath + std::to_string(index) + "/";
+
+			std::ifstream levelFile(path + "level");
+			if (!levelFile)
+				break;
+
+			int level = -1;
+			levelFile >> level;
+
+			std::string type;
+			std::ifstream typeFile(path + "type");
+			typeFile >> type;
+
+			// The shared CPU list is sorted, e.g., 0-7,64-71
+			int first = -1;
+			std::ifstream sharedFile(path + "shared_cpu_list");
+			sharedFile >> first;
+
+			if (type != "Instruction" && level > maxLevel && first >= 0) {
+				maxLevel = level;
+				leader = first;
+			}
+		}
+		return leader;
+	}
+
+	//! \brief Compute the last-level cache domains of the available CPUs
+	//!
+	//! The domains are numbered by NUMA node first, so that consecutive
+	//! domains are close. If the cache topology cannot be read, each NUMA
+	//! node is considered a single domain
+	static inline void initializeLLCDomains()
+	{
+		const size_t maxCPUs = _cpuToNUMANode.size();
+
+		std::vector<std::pair<int, int> > cpuKeys(maxCPUs, std::make_pair(-1, -1));
+		std::map<std::pair<int, int>, int> domains;
+
+		for (size_t c = 0; c < maxCPUs; ++c) {
+			const int numa = _cpuToNUMANode[c];
+			if (numa < 0)
+				continue;
+
+			cpuKeys[c] = std::make_pair(numa, getLLCLeader(c));
+			domains[cpuKeys[c]] = -1;
+		}
+
+		int domain = 0;
+		for (auto &entry : domains) {
+			entry.second = domain++;
+		}
+
+		_cpuToLLCDomain.assign(maxCPUs, -1);
+		for (size_t c = 0; c < maxCPUs; ++c) {
+			if (_cpuToNUMANode[c] >= 0) {
+				_cpuToLLCDomain[c] = domains[cpuKeys[c]];
+			}
+		}
+		_numLLCDomains = domains.size();
+		assert(_numLLCDomains > 0);
+	}
+
 public:
 	static inline void initialize()
 	{
@@ -78,6 +159,8 @@ public:
 		// Try to save space
 		_cpuToNUMANode.shrink_to_fit();
 		_numaNodeAvailability.shrink_to_fit();
+
+		initializeLLCDomains();
 	}
 
 	static inline void finalize()
@@ -120,6 +203,16 @@ public:
 	{
 		return _numaNodeAvailability;
 	}
+
+	static inline size_t getNumLLCDomains()
+	{
+		return _numLLCDomains;
+	}
+
+	static inline const std::vector<int> &getCPUToLLCDomain()
+	{
+		return _cpuToLLCDomain;
+	}
 };
 
 } // namespace tagaspi
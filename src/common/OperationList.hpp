@@ -0,0 +1,204 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef OPERATION_LIST_HPP
+#define OPERATION_LIST_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that describes the entries of a list operation. The entries are
+//! either the arrays of the caller or the result of coalescing them, which
+//! are stored in per-thread buffers and valid until the next coalescing
+//! of the same thread
+class OperationList {
+private:
+	//! The buffers holding the coalesced entries
+	struct Buffers {
+		std::vector<gaspi_number_t> order;
+		std::vector<gaspi_number_t> byAddress;
+		std::vector<gaspi_segment_id_t> segmentLocal;
+		std::vector<gaspi_offset_t> offsetLocal;
+		std::vector<gaspi_segment_id_t> segmentRemote;
+		std::vector<gaspi_offset_t> offsetRemote;
+		std::vector<gaspi_size_t> size;
+	};
+
+	static thread_local Buffers _buffers;
+
+	//! \brief Check whether the entry b starts where a ends, locally and remotely
+	inline bool contiguous(gaspi_number_t a, gaspi_number_t b) const
+	{
+		return segmentLocal[a] == segmentLocal[b]
+			&& segmentRemote[a] == segmentRemote[b]
+			&& offsetLocal[a] + size[a] == offsetLocal[b]
+			&& offsetRemote[a] + size[a] == offsetRemote[b];
+	}
+
+	//! \brief Check whether the entry a goes before b in remote address order
+	inline bool before(gaspi_number_t a, gaspi_number_t b) const
+	{
+		if (segmentRemote[a] != segmentRemote[b])
+			return segmentRemote[a] < segmentRemote[b];
+		return offsetRemote[a] < offsetRemote[b];
+	}
+
+	//! \brief Check whether any two entries overlap on one side
+	//!
+	//! The local side is the destination of reads and the remote side the
+	//! destination of writes, and both must be checked for either of them
+	//!
+	//! \param segments The segments of the side to check
+	//! \param offsets The offsets of the side to check
+	//! \param byAddress The buffer to sort the entries by address
+	inline bool overlapping(
+		const gaspi_segment_id_t *segments,
+		const gaspi_offset_t *offsets,
+		std::vector<gaspi_number_t> &byAddress
+	) const {
+		byAddress.resize(num);
+		for (gaspi_number_t e = 0; e < num; ++e)
+			byAddress[e] = e;
+
+		std::sort(byAddress.begin(), byAddress.end(),
+			[segments, offsets](gaspi_number_t a, gaspi_number_t b) {
+				if (segments[a] != segments[b])
+					return segments[a] < segments[b];
+				return offsets[a] < offsets[b];
+			}
+		);
+
+		// Keep the furthest end of the entries of the same segment
+		gaspi_offset_t end = 0;
+		for (gaspi_number_t e = 0; e < num; ++e) {
+			const gaspi_number_t entry = byAddress[e];
+			const bool sameSegment = (e > 0 && segments[byAddress[e - 1]] == segments[entry]);
+
+			if (sameSegment && offsets[entry] < end)
+				return true;
+
+			if (!sameSegment || offsets[entry] + size[entry] > end)
+				end = offsets[entry] + size[entry];
+		}
+		return false;
+	}
+
+public:
+	gaspi_number_t num;
+	gaspi_segment_id_t *segmentLocal;
+	gaspi_offset_t *offsetLocal;
+	gaspi_segment_id_t *segmentRemote;
+	gaspi_offset_t *offsetRemote;
+	gaspi_size_t *size;
+
+	inline OperationList(
+		gaspi_number_t num,
+		gaspi_segment_id_t *segmentLocal,
+		gaspi_offset_t *offsetLocal,
+		gaspi_segment_id_t *segmentRemote,
+		gaspi_offset_t *offsetRemote,
+		gaspi_size_t *size
+	) :
+		num(num),
+		segmentLocal(segmentLocal),
+		offsetLocal(offsetLocal),
+		segmentRemote(segmentRemote),
+		offsetRemote(offsetRemote),
+		size(size)
+	{
+	}
+
+	//! \brief Merge the entries that are contiguous both locally and remotely
+	//!
+	//! The entries are sorted by remote address before merging them, so
+	//! the order of the entries is not preserved. Lists whose entries
+	//! overlap locally or remotely are not reordered. The arrays of the caller are
+	//! never modified
+	//!
+	//! \returns Whether the number of entries was reduced
+	inline bool coalesce()
+	{
+		if (num < 2)
+			return false;
+
+		Buffers &buffers = _buffers;
+		std::vector<gaspi_number_t> &order = buffers.order;
+
+		order.resize(num);
+		for (gaspi_number_t e = 0; e < num; ++e)
+			order[e] = e;
+
+		// Avoid sorting lists that are already in order
+		bool sorted = true;
+		for (gaspi_number_t e = 1; e < num && sorted; ++e)
+			sorted = !before(e, e - 1);
+
+		if (!sorted) {
+			// Reordering overlapping entries could change the result
+			if (overlapping(segmentLocal, offsetLocal, buffers.byAddress)
+					|| overlapping(segmentRemote, offsetRemote, buffers.byAddress))
+				return false;
+
+			std::stable_sort(order.begin(), order.end(),
+				[this](gaspi_number_t a, gaspi_number_t b) {
+					return before(a, b);
+				}
+			);
+		}
+
+		// Count the merged entries before copying anything
+		gaspi_number_t merged = 1;
+		for (gaspi_number_t e = 1; e < num; ++e) {
+			if (!contiguous(order[e - 1], order[e]))
+				++merged;
+		}
+
+		if (merged == num)
+			return false;
+
+		buffers.segmentLocal.resize(merged);
+		buffers.offsetLocal.resize(merged);
+		buffers.segmentRemote.resize(merged);
+		buffers.offsetRemote.resize(merged);
+		buffers.size.resize(merged);
+
+		gaspi_number_t current = 0;
+		for (gaspi_number_t e = 0; e < num; ++e) {
+			const gaspi_number_t entry = order[e];
+
+			if (e > 0 && contiguous(order[e - 1], entry)) {
+				buffers.size[current - 1] += size[entry];
+				continue;
+			}
+			buffers.segmentLocal[current] = segmentLocal[entry];
+			buffers.offsetLocal[current] = offsetLocal[entry];
+			buffers.segmentRemote[current] = segmentRemote[entry];
+			buffers.offsetRemote[current] = offsetRemote[entry];
+			buffers.size[current] = size[entry];
+			++current;
+		}
+		assert(current == merged);
+
+		num = merged;
+		segmentLocal = buffers.segmentLocal.data();
+		offsetLocal = buffers.offsetLocal.data();
+		segmentRemote = buffers.segmentRemote.data();
+		offsetRemote = buffers.offsetRemote.data();
+		size = buffers.size.data();
+
+		return true;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // OPERATION_LIST_HPP
@@ -0,0 +1,192 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef PACKING_HPP
+#define PACKING_HPP
+
+#include <GASPI.h>
+
+#include "Environment.hpp"
+#include "TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that packs and unpacks strided regions into contiguous staging
+//! areas. The regions follow the layout of strided transfers: the first
+//! count is the size in bytes of the contiguous blocks, and the count d > 0
+//! is the number of blocks along dimension d, separated by the stride d-1
+class Packing {
+public:
+	//! The arguments of a task unpacking a region once notified
+	struct UnpackArgs {
+		TaskingModel::task_handle_t task;
+		const char *staging;
+		char *target;
+		std::vector<gaspi_size_t> strides;
+		std::vector<gaspi_size_t> counts;
+	};
+
+private:
+	//! \brief Copy a block; the common sizes use fixed-size copies that
+	//! the compiler lowers to vector loads and stores
+	static inline void copyBlock(char *destination, const char *source, gaspi_size_t size)
+	{
+		switch (size) {
+			case 4:
+				std::memcpy(destination, source, 4);
+				break;
+			case 8:
+				std::memcpy(destination, source, 8);
+				break;
+			case 16:
+				std::memcpy(destination, source, 16);
+				break;
+			case 32:
+				std::memcpy(destination, source, 32);
+				break;
+			default:
+				std::memcpy(destination, source, size);
+		}
+	}
+
+	//! \brief Get the number of leading dimensions that form contiguous blocks
+	static inline gaspi_number_t getContiguousDims(
+		const gaspi_size_t *strides,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts,
+		gaspi_size_t &blockSize
+	) {
+		blockSize = counts[0];
+
+		gaspi_number_t d = 1;
+		while (d < dims && strides[d - 1] == blockSize) {
+			blockSize *= counts[d];
+			++d;
+		}
+		return d;
+	}
+
+	//! \brief Copy between a strided region and a contiguous buffer
+	template <bool Gather>
+	static inline void transfer(
+		char *region,
+		char *buffer,
+		const gaspi_size_t *strides,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		gaspi_size_t blockSize;
+		const gaspi_number_t first = getContiguousDims(strides, dims, counts, blockSize);
+
+		std::vector<gaspi_size_t> index(dims, 0);
+
+		bool done = false;
+		while (!done) {
+			gaspi_offset_t offset = 0;
+			for (gaspi_number_t d = first; d < dims; ++d)
+				offset += index[d] * strides[d - 1];
+
+			// The innermost dimension is a tight loop over blocks
+			const gaspi_size_t innerCount = (first < dims) ? counts[first] : 1;
+			const gaspi_size_t innerStride = (first < dims) ? strides[first - 1] : 0;
+
+			for (gaspi_size_t b = 0; b < innerCount; ++b) {
+				if (Gather)
+					copyBlock(buffer, region + offset, blockSize);
+				else
+					copyBlock(region + offset, buffer, blockSize);
+
+				buffer += blockSize;
+				offset += innerStride;
+			}
+
+			// Advance the outer dimensions, the first one fastest
+			done = true;
+			for (gaspi_number_t d = first + 1; d < dims; ++d) {
+				if (++index[d] < counts[d]) {
+					done = false;
+					break;
+				}
+				index[d] = 0;
+			}
+		}
+	}
+
+public:
+	//! \brief Get the total size in bytes of a region
+	static inline gaspi_size_t getSize(gaspi_number_t dims, const gaspi_size_t *counts)
+	{
+		gaspi_size_t size = 1;
+		for (gaspi_number_t d = 0; d < dims; ++d)
+			size *= counts[d];
+		return size;
+	}
+
+	//! \brief Check whether a region is worth packing
+	//!
+	//! The decision only depends on the layout of the region, so both
+	//! sides of a transfer take the same decision for the remote layout
+	static inline bool mustPack(
+		const gaspi_size_t *strides,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		gaspi_size_t blockSize;
+		const gaspi_number_t first = getContiguousDims(strides, dims, counts, blockSize);
+
+		// Contiguous regions never need packing
+		if (first == dims)
+			return false;
+
+		return (blockSize < _env.packingThreshold);
+	}
+
+	//! \brief Gather a strided region into a contiguous buffer
+	static inline void pack(
+		char *buffer,
+		const char *region,
+		const gaspi_size_t *strides,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		transfer<true>(const_cast<char *>(region), buffer, strides, dims, counts);
+	}
+
+	//! \brief Scatter a contiguous buffer into a strided region
+	static inline void unpack(
+		char *region,
+		const char *buffer,
+		const gaspi_size_t *strides,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		transfer<false>(region, const_cast<char *>(buffer), strides, dims, counts);
+	}
+
+	//! \brief Body of the tasks that unpack a region once notified
+	static inline void unpackTask(void *args)
+	{
+		UnpackArgs *unpackArgs = static_cast<UnpackArgs *>(args);
+		assert(unpackArgs != nullptr);
+
+		unpack(unpackArgs->target, unpackArgs->staging,
+			unpackArgs->strides.data(), unpackArgs->counts.size(),
+			unpackArgs->counts.data());
+
+		TaskingModel::decreaseTaskEvents(unpackArgs->task, 1);
+
+		delete unpackArgs;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // PACKING_HPP
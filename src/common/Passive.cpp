@@ -0,0 +1,122 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+
+#include "Passive.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+std::deque<Passive::PendingPassive> Passive::_sends;
+std::deque<Passive::PendingPassive> Passive::_receives;
+bool Passive::_sending = false;
+bool Passive::_receiving = false;
+std::atomic<uint64_t> Passive::_numPending(0);
+SpinLock Passive::_lock;
+
+void Passive::initialize()
+{
+	assert(_sends.empty() && _receives.empty());
+}
+
+void Passive::finalize()
+{
+	assert(_numPending.load() == 0);
+}
+
+void Passive::send(const PendingPassive &operation)
+{
+	bool spawn;
+	{
+		std::lock_guard<SpinLock> guard(_lock);
+		_sends.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_relaxed);
+
+		spawn = !_sending;
+		_sending = true;
+	}
+
+	if (spawn)
+		TaskingModel::spawnTask("TAGASPI PASSIVE SEND", runSends, nullptr);
+}
+
+void Passive::receive(const PendingPassive &operation)
+{
+	bool spawn;
+	{
+		std::lock_guard<SpinLock> guard(_lock);
+		_receives.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_relaxed);
+
+		spawn = !_receiving;
+		_receiving = true;
+	}
+
+	if (spawn)
+		TaskingModel::spawnTask("TAGASPI PASSIVE RECEIVE", runReceives, nullptr);
+}
+
+void Passive::runSends(void *)
+{
+	while (true) {
+		PendingPassive operation;
+		{
+			// The task finishes once it finds no sends, so the next
+			// send spawns another one
+			std::lock_guard<SpinLock> guard(_lock);
+			if (_sends.empty()) {
+				_sending = false;
+				return;
+			}
+			operation = _sends.front();
+			_sends.pop_front();
+		}
+
+		gaspi_return_t eret = gaspi_passive_send(operation.segment, operation.offset,
+					operation.rank, operation.size, GASPI_BLOCK);
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when sending a passive message");
+
+		_numPending.fetch_sub(1, std::memory_order_relaxed);
+
+		TaskingModel::decreaseTaskEvents(operation.task, 1);
+	}
+}
+
+void Passive::runReceives(void *)
+{
+	while (true) {
+		PendingPassive operation;
+		{
+			std::lock_guard<SpinLock> guard(_lock);
+			if (_receives.empty()) {
+				_receiving = false;
+				return;
+			}
+			operation = _receives.front();
+			_receives.pop_front();
+		}
+
+		gaspi_rank_t sourceRank;
+		gaspi_return_t eret = gaspi_passive_receive(operation.segment, operation.offset,
+					&sourceRank, operation.size, GASPI_BLOCK);
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when receiving a passive message");
+
+		_numPending.fetch_sub(1, std::memory_order_relaxed);
+
+		if (operation.sourceRank != nullptr)
+			*operation.sourceRank = sourceRank;
+
+		TaskingModel::decreaseTaskEvents(operation.task, 1);
+	}
+}
+
+} // namespace tagaspi
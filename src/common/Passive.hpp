@@ -0,0 +1,86 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef PASSIVE_HPP
+#define PASSIVE_HPP
+
+#include <GASPI.h>
+
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+namespace tagaspi {
+
+//! Class that runs the passive communication on behalf of tasks. The
+//! passive operations of GASPI are blocking and cannot be retried without
+//! posting them again, so they are queued and run by spawned tasks instead
+//! of the calling task or a polling instance. A single task runs the sends
+//! and another one the receives, each in calling order, while there are
+//! operations queued. A single event of the task is decreased once the
+//! operation finishes
+class Passive {
+public:
+	//! A passive operation waiting to run
+	struct PendingPassive {
+		TaskingModel::task_handle_t task;
+
+		gaspi_segment_id_t segment;
+		gaspi_offset_t offset;
+		gaspi_size_t size;
+
+		//! The destination rank of sends
+		gaspi_rank_t rank;
+
+		//! The location of the source rank of receives, which may be null
+		gaspi_rank_t *sourceRank;
+	};
+
+private:
+	//! The sends in calling order
+	static std::deque<PendingPassive> _sends;
+
+	//! The receives in calling order
+	static std::deque<PendingPassive> _receives;
+
+	//! Whether a task is running the sends and the receives, respectively
+	static bool _sending;
+	static bool _receiving;
+
+	//! The number of operations waiting to run
+	static std::atomic<uint64_t> _numPending;
+
+	//! The lock protecting the pending operations and the running flags
+	static SpinLock _lock;
+
+	//! \brief Run the queued sends in order until there are none
+	static void runSends(void *args);
+
+	//! \brief Run the queued receives in order until there are none
+	static void runReceives(void *args);
+
+public:
+	static void initialize();
+
+	static void finalize();
+
+	//! \brief Queue a passive send
+	//!
+	//! The caller must have increased an event of the task
+	static void send(const PendingPassive &operation);
+
+	//! \brief Queue a passive receive
+	//!
+	//! The caller must have increased an event of the task
+	static void receive(const PendingPassive &operation);
+};
+
+} // namespace tagaspi
+
+#endif // PASSIVE_HPP
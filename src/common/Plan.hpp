@@ -0,0 +1,241 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef PLAN_HPP
+#define PLAN_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "Environment.hpp"
+#include "FlowControl.hpp"
+#include "OperationList.hpp"
+#include "TaskingModel.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that represents a persistent communication plan. A plan records
+//! a sequence of operations once, with their descriptors and number of
+//! requests already computed. Starting the plan submits all operations
+//! on behalf of the calling task with a single increase of its events
+class Plan {
+private:
+	//! A recorded operation of the plan
+	struct PlanOperation {
+		gaspi_operation_type_t type;
+		gaspi_rank_t rank;
+		gaspi_queue_id_t queue;
+		gaspi_number_t numRequests;
+
+		// Arguments of single operations
+		gaspi_segment_id_t segmentLocal;
+		gaspi_offset_t offsetLocal;
+		gaspi_segment_id_t segmentRemote;
+		gaspi_offset_t offsetRemote;
+		gaspi_size_t size;
+
+		// Arguments of list operations, copied from the caller
+		std::vector<gaspi_segment_id_t> segmentsLocal;
+		std::vector<gaspi_offset_t> offsetsLocal;
+		std::vector<gaspi_segment_id_t> segmentsRemote;
+		std::vector<gaspi_offset_t> offsetsRemote;
+		std::vector<gaspi_size_t> sizes;
+
+		gaspi_segment_id_t segmentNotification;
+		gaspi_notification_id_t notificationId;
+		gaspi_notification_t notificationValue;
+	};
+
+	//! The operations in submission order
+	std::vector<PlanOperation> _operations;
+
+	//! The requests of all operations
+	uint64_t _numRequests;
+
+	//! \brief Submit a recorded operation on behalf of a task
+	static inline gaspi_return_t post(TaskingModel::task_handle_t task, PlanOperation &operation)
+	{
+		gaspi_return_t eret;
+		const bool isList = !operation.sizes.empty();
+
+		if (FlowControl::isEnabled()) {
+			if (isList) {
+				eret = FlowControl::submitList((gaspi_tag_t) task, operation.numRequests, operation.type,
+							operation.sizes.size(), operation.segmentsLocal.data(),
+							operation.offsetsLocal.data(), operation.rank,
+							operation.segmentsRemote.data(), operation.offsetsRemote.data(),
+							operation.sizes.data(), operation.segmentNotification,
+							operation.notificationId, operation.notificationValue,
+							operation.queue);
+			} else {
+				eret = FlowControl::submit((gaspi_tag_t) task, operation.numRequests, operation.type,
+							operation.segmentLocal, operation.offsetLocal, operation.rank,
+							operation.segmentRemote, operation.offsetRemote, operation.size,
+							operation.notificationId, operation.notificationValue,
+							operation.queue);
+			}
+		} else if (isList) {
+			eret = gaspi_operation_list_submit(operation.type, (gaspi_tag_t) task,
+						operation.sizes.size(), operation.segmentsLocal.data(),
+						operation.offsetsLocal.data(), operation.rank,
+						operation.segmentsRemote.data(), operation.offsetsRemote.data(),
+						operation.sizes.data(), operation.segmentNotification,
+						operation.notificationId, operation.notificationValue,
+						operation.queue, GASPI_BLOCK);
+			assert(eret != GASPI_TIMEOUT);
+		} else {
+			eret = gaspi_operation_submit(operation.type, (gaspi_tag_t) task,
+						operation.segmentLocal, operation.offsetLocal, operation.rank,
+						operation.segmentRemote, operation.offsetRemote, operation.size,
+						operation.notificationId, operation.notificationValue,
+						operation.queue, GASPI_BLOCK);
+			assert(eret != GASPI_TIMEOUT);
+		}
+		return eret;
+	}
+
+	//! \brief Record an operation and account its requests
+	inline gaspi_return_t record(PlanOperation &operation, gaspi_number_t num)
+	{
+		if (operation.queue >= _env.maxQueues) {
+			fprintf(stderr, "Error: Queue %d of plan operation is not valid\n", operation.queue);
+			return GASPI_ERROR;
+		}
+
+		gaspi_return_t eret = gaspi_operation_get_num_requests(operation.type, num, &operation.numRequests);
+		if (eret != GASPI_SUCCESS)
+			return eret;
+
+		// Recorded lists are never split, so they must fit in a queue
+		if (operation.numRequests > _env.queueSizeMax) {
+			fprintf(stderr, "Error: Plan operation does not fit in a queue\n");
+			return GASPI_ERROR;
+		}
+
+		_numRequests += operation.numRequests;
+		_operations.push_back(std::move(operation));
+
+		return GASPI_SUCCESS;
+	}
+
+public:
+	inline Plan() :
+		_operations(),
+		_numRequests(0)
+	{
+	}
+
+	//! \brief Record a single operation
+	inline gaspi_return_t add(
+		gaspi_operation_type_t type,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	) {
+		assert(type == GASPI_OP_WRITE || type == GASPI_OP_READ
+			|| type == GASPI_OP_NOTIFY || type == GASPI_OP_WRITE_NOTIFY);
+
+		PlanOperation operation;
+		operation.type = type;
+		operation.rank = rank;
+		operation.queue = queue;
+		operation.numRequests = 0;
+		operation.segmentLocal = segmentLocal;
+		operation.offsetLocal = offsetLocal;
+		operation.segmentRemote = segmentRemote;
+		operation.offsetRemote = offsetRemote;
+		operation.size = size;
+		operation.segmentNotification = segmentRemote;
+		operation.notificationId = notificationId;
+		operation.notificationValue = notificationValue;
+
+		return record(operation, 1);
+	}
+
+	//! \brief Record a list operation
+	//!
+	//! The entries are coalesced once here instead of at every start
+	inline gaspi_return_t addList(
+		gaspi_operation_type_t type,
+		OperationList list,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentNotification,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	) {
+		assert(type == GASPI_OP_WRITE_LIST || type == GASPI_OP_READ_LIST
+			|| type == GASPI_OP_WRITE_LIST_NOTIFY);
+
+		if (list.num == 0) {
+			fprintf(stderr, "Error: Plan list operation has no entries\n");
+			return GASPI_ERROR;
+		}
+
+		if (_env.listCoalescing)
+			list.coalesce();
+
+		PlanOperation operation;
+		operation.type = type;
+		operation.rank = rank;
+		operation.queue = queue;
+		operation.numRequests = 0;
+		operation.segmentLocal = 0;
+		operation.offsetLocal = 0;
+		operation.segmentRemote = 0;
+		operation.offsetRemote = 0;
+		operation.size = 0;
+		operation.segmentsLocal.assign(list.segmentLocal, list.segmentLocal + list.num);
+		operation.offsetsLocal.assign(list.offsetLocal, list.offsetLocal + list.num);
+		operation.segmentsRemote.assign(list.segmentRemote, list.segmentRemote + list.num);
+		operation.offsetsRemote.assign(list.offsetRemote, list.offsetRemote + list.num);
+		operation.sizes.assign(list.size, list.size + list.num);
+		operation.segmentNotification = segmentNotification;
+		operation.notificationId = notificationId;
+		operation.notificationValue = notificationValue;
+
+		return record(operation, list.num);
+	}
+
+	//! \brief Submit all operations on behalf of a task
+	//!
+	//! The events of the task are increased once for the whole plan. If
+	//! an operation fails, the events of the remaining ones are undone
+	inline gaspi_return_t start(TaskingModel::task_handle_t task)
+	{
+		if (_numRequests == 0)
+			return GASPI_SUCCESS;
+
+		TaskingModel::increaseCurrentTaskEvents(task, _numRequests);
+
+		uint64_t submitted = 0;
+		for (PlanOperation &operation : _operations) {
+			gaspi_return_t eret = post(task, operation);
+			if (eret != GASPI_SUCCESS) {
+				TaskingModel::decreaseTaskEvents(task, _numRequests - submitted);
+				return eret;
+			}
+			submitted += operation.numRequests;
+		}
+		return GASPI_SUCCESS;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // PLAN_HPP
@@ -8,12 +8,18 @@
 #include <GASPI_Lowlevel.h>
 
 #include "Allocator.hpp"
+#include "ChunkedCompletion.hpp"
+#include "Completion.hpp"
+#include "DeferredRequests.hpp"
 #include "Environment.hpp"
+#include "FlowControl.hpp"
 #include "Polling.hpp"
+#include "SplitList.hpp"
 #include "TaskingModel.hpp"
 #include "WaitingRange.hpp"
 #include "WaitingRangeList.hpp"
 #include "WaitingRangeQueue.hpp"
+#include "util/RCU.hpp"
 #include "util/Utils.hpp"
 
 #include <algorithm>
@@ -26,6 +32,8 @@ namespace tagaspi {
 uint64_t Polling::_period = 100;
 std::vector<Polling::QueuePollingInfo> Polling::_queuePollingInfos;
 TaskingModel::PollingInstance *Polling::_notificationsPollingInstance;
+TaskingModel::PollingInstance *Polling::_queueGroupsPollingInstance = nullptr;
+std::atomic<bool> Polling::_queueGroupsPolling(false);
 
 void Polling::initialize()
 {
@@ -70,6 +78,17 @@ void Polling::initialize()
 
 	_notificationsPollingInstance =
 		TaskingModel::registerPolling("TAGASPI NOTIFICATIONS", pollNotifications, nullptr);
+
+}
+
+void Polling::enableQueueGroupsPolling()
+{
+	// Only the first elastic group registers the polling instance
+	if (_queueGroupsPolling.exchange(true, std::memory_order_acq_rel))
+		return;
+
+	_queueGroupsPollingInstance =
+		TaskingModel::registerPolling("TAGASPI QUEUE GROUPS", pollQueueGroups, nullptr);
 }
 
 void Polling::finalize()
@@ -79,10 +98,45 @@ void Polling::finalize()
 			TaskingModel::unregisterPolling(info.pollingInstance);
 	}
 	TaskingModel::unregisterPolling(_notificationsPollingInstance);
+	if (_queueGroupsPolling.exchange(false, std::memory_order_acq_rel))
+		TaskingModel::unregisterPolling(_queueGroupsPollingInstance);
 
 	_queuePollingInfos.clear();
 }
 
+void Polling::pollQueue(gaspi_queue_id_t queue)
+{
+	gaspi_number_t completedReqs, r;
+	gaspi_status_t statuses[BatchSize];
+	gaspi_tag_t tags[BatchSize];
+	gaspi_return_t eret;
+
+	do {
+		eret = gaspi_request_wait(queue, BatchSize, &completedReqs, tags, statuses, GASPI_TEST);
+		if (eret != GASPI_SUCCESS && eret != GASPI_TIMEOUT) {
+			// We are probably cheking queues that are not created
+			if (eret != GASPI_ERR_INV_QUEUE) {
+				fprintf(stderr, "Error: Return code %d from gaspi_request_wait\n", eret);
+				abort();
+			}
+			completedReqs = 0;
+			continue;
+		}
+		assert(completedReqs <= BatchSize);
+
+		for (r = 0; r < completedReqs; ++r) {
+			if (statuses[r].error != GASPI_SUCCESS) {
+				fprintf(stderr, "Error: GASPI operation with tag %lld failed\n", tags[r]);
+				abort();
+			}
+
+			if (tags[r] != GASPI_TAG_NULL) {
+				Completion::requestCompleted(tags[r]);
+			}
+		}
+	} while (completedReqs == BatchSize);
+}
+
 uint64_t Polling::pollQueues(void *data)
 {
 	QueuePollingInfo *info = (QueuePollingInfo *) data;
@@ -95,40 +149,24 @@ uint64_t Polling::pollQueues(void *data)
 	assert(queue < _env.maxQueues);
 	assert(numQueues <= _env.maxQueues);
 
-	gaspi_number_t completedReqs, r;
-	gaspi_status_t statuses[BatchSize];
-	gaspi_tag_t tags[BatchSize];
-	gaspi_return_t eret;
+	for (; queue < numQueues; ++queue)
+		pollQueue(queue);
 
-	for (; queue < numQueues; ++queue) {
-		do {
-			eret = gaspi_request_wait(queue, BatchSize, &completedReqs, tags, statuses, GASPI_TEST);
-			if (eret != GASPI_SUCCESS && eret != GASPI_TIMEOUT) {
-				// We are probably cheking queues that are not created
-				if (eret != GASPI_ERR_INV_QUEUE) {
-					fprintf(stderr, "Error: Return code %d from gaspi_request_wait\n", eret);
-					abort();
-				}
-				completedReqs = 0;
-				continue;
-			}
-			assert(completedReqs <= BatchSize);
+	// Submit the operations waiting for the returned credits
+	if (FlowControl::isEnabled())
+		FlowControl::progress();
 
-			for (r = 0; r < completedReqs; ++r) {
-				if (statuses[r].error != GASPI_SUCCESS) {
-					fprintf(stderr, "Error: GASPI operation with tag %lld failed\n", tags[r]);
-					abort();
-				}
+	// Submit the chunks of split lists waiting for queue space
+	if (SplitList::hasPending())
+		SplitList::progress();
 
-				if (tags[r] != GASPI_TAG_NULL) {
-					TaskingModel::task_handle_t task = (TaskingModel::task_handle_t) tags[r];
-					assert(task != nullptr);
+	// Post the notifications of chunked operations waiting for queue space
+	if (ChunkedCompletion::hasParked())
+		ChunkedCompletion::progress();
 
-					TaskingModel::decreaseTaskEvents(task, 1);
-				}
-			}
-		} while (completedReqs == BatchSize);
-	}
+	// Submit the operations of requests waiting for queue space
+	if (DeferredRequests::hasPending())
+		DeferredRequests::progress();
 
 	return _period;
 }
@@ -161,4 +199,19 @@ uint64_t Polling::pollNotifications(void *)
 	return _period;
 }
 
+uint64_t Polling::pollQueueGroups(void *)
+{
+	// Prevent the groups from being released while adjusted
+	util::RCUReadGuard guard;
+
+	_env.queueGroups.forEach(
+		[](QueueGroup *queueGroup) {
+			if (queueGroup->isElastic())
+				queueGroup->adjustElasticQueues(_env.queueSizeMax);
+		}
+	);
+
+	return _period;
+}
+
 } // namespace tagaspi
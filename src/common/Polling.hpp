@@ -13,6 +13,7 @@
 #include "util/EnvironmentVariable.hpp"
 #include "util/SpinLock.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 
@@ -39,14 +40,37 @@ private:
 	//! the GASPI notifications in TAGASPI
 	static TaskingModel::PollingInstance *_notificationsPollingInstance;
 
+	//! The handle to the polling instance that periodically adjusts
+	//! the queues of the elastic queue groups
+	static TaskingModel::PollingInstance *_queueGroupsPollingInstance;
+
+	//! Whether the queue groups polling instance is registered
+	static std::atomic<bool> _queueGroupsPolling;
+
 public:
 	static void initialize();
 
 	static void finalize();
 
+	//! \brief Get the period in microseconds of the polling instances
+	static inline uint64_t getPeriod()
+	{
+		return _period;
+	}
+
+	//! \brief Register the polling instance of the elastic queue groups
+	//!
+	//! Only the first call registers it; the rest have no effect
+	static void enableQueueGroupsPolling();
+
+	//! \brief Process the completed requests of a queue
+	static void pollQueue(gaspi_queue_id_t queue);
+
 	static uint64_t pollQueues(void *data);
 
 	static uint64_t pollNotifications(void *data);
+
+	static uint64_t pollQueueGroups(void *data);
 };
 
 } // namespace tagaspi
@@ -13,11 +13,15 @@
 #include <config.h>
 
 #include "HardwareInfo.hpp"
+#include "TaskingModel.hpp"
 #include "util/Utils.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <sys/sysinfo.h>
 #include <vector>
 
@@ -29,49 +33,262 @@ private:
 	typedef gaspi_number_t number_t;
 	typedef gaspi_queue_group_policy_t policy_t;
 
-	queue_id_t _firstQueue;
-	number_t _numQueues;
+	//! Round-robin cursor of a CPU, padded to avoid false sharing
+	struct alignas(CACHELINE_SIZE) Cursor {
+		std::atomic<number_t> offset;
+	};
+
+	//! Queue assignation of the CPU round-robin policy. The queue offsets
+	//! are computed per system CPU from the last-level cache domains, and
+	//! copied to the dense table of logical CPUs on their first use
+	struct CPUQueueMap {
+		std::vector<number_t> systemOffsets;
+		std::vector<std::atomic<int> > logicalOffsets;
+	};
+
+	//! State of the groups whose queues are created by TAGASPI
+	struct ElasticState {
+		//! The minimum and maximum number of queues in use
+		number_t minQueues;
+		number_t maxQueues;
+
+		//! The number of queues created so far
+		number_t numCreated;
+
+		//! The consecutive samples with high and low occupancy
+		number_t highSamples;
+		number_t lowSamples;
+	};
+
+	//! The occupancy percentages that grow and shrink elastic groups
+	static constexpr uint64_t HighOccupancy = 50;
+	static constexpr uint64_t LowOccupancy = 5;
+
+	//! The consecutive samples needed to grow and shrink elastic groups
+	static constexpr number_t GrowSamples = 8;
+	static constexpr number_t ShrinkSamples = 1000;
+
+	//! The queues of the group, where only the first _numQueues are in use
+	std::vector<queue_id_t> _queues;
+	std::atomic<number_t> _numQueues;
 	policy_t _policy;
 	void *_data;
 
+	//! The optional subgroup of queues for bulk operations, which
+	//! receives the operations of at least _sizeThreshold bytes
+	QueueGroup *_bulkGroup;
+	gaspi_size_t _sizeThreshold;
+
+	//! The elastic state or nullptr if the queues are fixed
+	ElasticState *_elastic;
+
 public:
 	inline QueueGroup(queue_id_t first, number_t num) :
-		_firstQueue(first),
+		_queues(num),
 		_numQueues(num),
-		_data(nullptr)
+		_data(nullptr),
+		_bulkGroup(nullptr),
+		_sizeThreshold(0),
+		_elastic(nullptr)
 	{
 		assert(num > 0);
+
+		for (number_t q = 0; q < num; ++q) {
+			_queues[q] = first + q;
+		}
+	}
+
+	//! \brief Construct an elastic group from the queues created by TAGASPI
+	//!
+	//! \param queues The initially created queues, which are the minimum
+	//! \param maxQueues The maximum number of queues of the group
+	inline QueueGroup(const std::vector<queue_id_t> &queues, number_t maxQueues) :
+		_queues(maxQueues),
+		_numQueues(queues.size()),
+		_data(nullptr),
+		_bulkGroup(nullptr),
+		_sizeThreshold(0),
+		_elastic(new ElasticState())
+	{
+		assert(!queues.empty());
+		assert(queues.size() <= maxQueues);
+
+		std::copy(queues.begin(), queues.end(), _queues.begin());
+
+		_elastic->minQueues = queues.size();
+		_elastic->maxQueues = maxQueues;
+		_elastic->numCreated = queues.size();
+		_elastic->highSamples = 0;
+		_elastic->lowSamples = 0;
 	}
 
+	//! \brief Release the group and the queues it created
+	//!
+	//! The caller must have drained the created queues, since the requests
+	//! still in them would never complete
 	inline ~QueueGroup()
 	{
 		if (_data != nullptr) {
 			cleanupPolicyData();
 		}
+		if (_bulkGroup != nullptr) {
+			delete _bulkGroup;
+		}
+		if (_elastic != nullptr) {
+			/* Release the queues created by TAGASPI */
+			for (number_t q = 0; q < _elastic->numCreated; ++q) {
+				gaspi_return_t eret = gaspi_queue_delete(_queues[q]);
+				if (eret != GASPI_SUCCESS) {
+					fprintf(stderr, "Warning: Return code %d from gaspi_queue_delete\n", eret);
+				}
+			}
+			delete _elastic;
+		}
 	}
 
 	inline queue_id_t getQueue()
 	{
-		queue_id_t queue = _firstQueue;
-		if (_policy == GASPI_QUEUE_GROUP_POLICY_DEFAULT) {
-			if (_numQueues > 1) {
-				assert(_data != nullptr);
-				std::atomic<number_t> &counter = *((std::atomic<number_t> *)_data);
+		return _queues[getOffset()];
+	}
+
+	inline queue_id_t getQueue(gaspi_rank_t rank)
+	{
+		return _queues[getOffset(rank)];
+	}
+
+	inline queue_id_t getQueueForSize(gaspi_size_t size)
+	{
+		return getSubgroup(size)->getQueue();
+	}
+
+	inline queue_id_t getQueue(gaspi_rank_t rank, gaspi_size_t size)
+	{
+		return getSubgroup(size)->getQueue(rank);
+	}
+
+	//! \brief Get the next offset of the calling thread in round-robin
+	//!
+	//! The CPU of the caller is only known inside tasks, so the callers
+	//! outside tasks, e.g., the main thread, rotate through the queues
+	static inline number_t getThreadOffset(number_t numQueues)
+	{
+		static thread_local number_t cursor = 0;
 
-				number_t offset = counter.load();
-				number_t nextOffset = (offset < _numQueues - 1) ? offset + 1 : 0;
-				queue = _firstQueue + offset;
+		number_t offset = (cursor < numQueues) ? cursor : 0;
+		cursor = (offset < numQueues - 1) ? offset + 1 : 0;
+		return offset;
+	}
 
-				/* In case the operation fails, another thread will update it */
-				counter.compare_exchange_strong(offset, nextOffset);
+	//! \brief Get the offset of the queue chosen by the policy
+	inline number_t getOffset()
+	{
+		number_t offset = 0;
+		if (_policy != GASPI_QUEUE_GROUP_POLICY_RANK && TaskingModel::getCurrentTask() == nullptr) {
+			/* The acquire pairs with the activation of elastic queues */
+			const number_t numQueues = _numQueues.load(std::memory_order_acquire);
+			if (numQueues > 1)
+				offset = getThreadOffset(numQueues);
+		} else if (_policy == GASPI_QUEUE_GROUP_POLICY_DEFAULT) {
+			/* The acquire pairs with the activation of elastic queues */
+			const number_t numQueues = _numQueues.load(std::memory_order_acquire);
+			if (numQueues > 1) {
+				size_t cpu = TaskingModel::getCurrentLogicalCPU();
+				Cursor *cursors = (Cursor *)_data;
+				assert(cursors != nullptr);
+
+				/* Only the thread running on the CPU updates its cursor, so
+				 * there is no shared write. A preemption in between may only
+				 * repeat a queue, which does not break the distribution */
+				std::atomic<number_t> &cursor = cursors[cpu].offset;
+				offset = cursor.load(std::memory_order_relaxed);
+				if (offset >= numQueues)
+					offset = 0;
+
+				number_t nextOffset = (offset < numQueues - 1) ? offset + 1 : 0;
+				cursor.store(nextOffset, std::memory_order_relaxed);
+			}
+		} else if (_policy == GASPI_QUEUE_GROUP_POLICY_CPU_RR) {
+			CPUQueueMap *map = (CPUQueueMap *)_data;
+			assert(map != nullptr);
+
+			size_t cpu = TaskingModel::getCurrentLogicalCPU();
+			assert(cpu < map->logicalOffsets.size());
+
+			int assigned = map->logicalOffsets[cpu].load(std::memory_order_relaxed);
+			if (assigned < 0) {
+				/* First use of the CPU; resolve its system CPU once */
+				size_t systemCPU = TaskingModel::getCurrentSystemCPU();
+				if (systemCPU < map->systemOffsets.size()) {
+					assigned = map->systemOffsets[systemCPU];
+				} else {
+					assigned = cpu % _queues.size();
+				}
+				map->logicalOffsets[cpu].store(assigned, std::memory_order_relaxed);
 			}
+			offset = (number_t) assigned;
 		} else {
-			size_t cpu = HardwareInfo::getCurrentCPU();
-			gaspi_queue_id_t *queues = (gaspi_queue_id_t *)_data;
-			assert(queues != nullptr);
-			queue = queues[cpu];
+			/* The rank policy requires the destination rank */
+			assert(false);
+		}
+		return offset;
+	}
+
+	//! \brief Get the offset of the queue chosen by the policy for a rank
+	inline number_t getOffset(gaspi_rank_t rank)
+	{
+		if (_policy == GASPI_QUEUE_GROUP_POLICY_RANK) {
+			/* Operations to the same rank always share the queue */
+			return rank % _numQueues.load(std::memory_order_relaxed);
 		}
-		return queue;
+		return getOffset();
+	}
+
+	//! \brief Get the number of queues in use
+	inline number_t getNumQueues() const
+	{
+		return _numQueues.load(std::memory_order_acquire);
+	}
+
+	//! \brief Get the queue at an offset lower than the number of queues
+	inline queue_id_t getQueueAt(number_t offset) const
+	{
+		assert(offset < _queues.size());
+		return _queues[offset];
+	}
+
+	//! \brief Get the subgroup that serves operations of a given size
+	inline QueueGroup *getSubgroup(gaspi_size_t size)
+	{
+		if (_bulkGroup != nullptr && size >= _sizeThreshold)
+			return _bulkGroup;
+		return this;
+	}
+
+	inline bool requiresRank() const
+	{
+		return _policy == GASPI_QUEUE_GROUP_POLICY_RANK;
+	}
+
+	//! \brief Get the number of queues created by TAGASPI for the group
+	//!
+	//! These are the first queues of the group
+	inline number_t getNumCreatedQueues() const
+	{
+		return (_elastic != nullptr) ? _elastic->numCreated : 0;
+	}
+
+	inline bool isElastic() const
+	{
+		return _elastic != nullptr;
+	}
+
+	inline void setBulkSubgroup(QueueGroup *bulkGroup, gaspi_size_t sizeThreshold)
+	{
+		assert(bulkGroup != nullptr);
+		assert(_bulkGroup == nullptr);
+
+		_bulkGroup = bulkGroup;
+		_sizeThreshold = sizeThreshold;
 	}
 
 	inline void setupPolicy(policy_t policy)
@@ -79,90 +296,141 @@ public:
 		_policy = policy;
 
 		if (_policy == GASPI_QUEUE_GROUP_POLICY_DEFAULT) {
-			_data = new std::atomic<number_t>(0);
-			assert(_data != nullptr);
-		} else {
-			_data = new queue_id_t[HardwareInfo::getMaxCPUs()]();
-			assert(_data != nullptr);
+			const size_t numCPUs = TaskingModel::getNumCPUs();
+
+			Cursor *cursors = new Cursor[numCPUs];
+			assert(cursors != nullptr);
+
+			/* Stagger the starting offsets of the CPUs */
+			for (size_t cpu = 0; cpu < numCPUs; ++cpu) {
+				std::atomic_init(&cursors[cpu].offset, (number_t) (cpu % _numQueues));
+			}
+			_data = cursors;
+		} else if (_policy == GASPI_QUEUE_GROUP_POLICY_CPU_RR) {
+			CPUQueueMap *map = new CPUQueueMap();
+			assert(map != nullptr);
+
+			setupCPURoundRobinData(map);
+			_data = map;
+		}
+	}
+
+	//! \brief Grow or shrink an elastic group depending on the occupancy
+	//!
+	//! This function samples the occupancy of the queues in use. The group
+	//! grows when the occupancy stays high and shrinks when it stays low.
+	//! Shrinking only retires the last queue, which is not deleted, since
+	//! tasks may still hold its identifier. Retired queues are reused first
+	//! when the group grows again. This function cannot be called
+	//! concurrently on the same group
+	//!
+	//! \param queueSizeMax The maximum number of requests of a queue
+	inline void adjustElasticQueues(gaspi_number_t queueSizeMax)
+	{
+		assert(_elastic != nullptr);
+		assert(queueSizeMax > 0);
+
+		const number_t numQueues = _numQueues.load(std::memory_order_relaxed);
+
+		uint64_t occupied = 0;
+		for (number_t q = 0; q < numQueues; ++q) {
+			gaspi_number_t size;
+			if (gaspi_queue_size(_queues[q], &size) == GASPI_SUCCESS)
+				occupied += size;
+		}
 
-			setupCPURoundRobinData((queue_id_t *)_data);
+		const uint64_t occupancy = (occupied * 100) / ((uint64_t) numQueues * queueSizeMax);
+
+		if (occupancy >= HighOccupancy) {
+			_elastic->lowSamples = 0;
+			if (++_elastic->highSamples >= GrowSamples && numQueues < _elastic->maxQueues) {
+				_elastic->highSamples = 0;
+
+				if (numQueues == _elastic->numCreated) {
+					queue_id_t queue;
+					gaspi_return_t eret = gaspi_queue_create(&queue, GASPI_BLOCK);
+					if (eret != GASPI_SUCCESS) {
+						/* Stop growing if GASPI cannot provide more queues */
+						fprintf(stderr, "Warning: Return code %d from gaspi_queue_create\n", eret);
+						_elastic->maxQueues = numQueues;
+						return;
+					}
+					_queues[numQueues] = queue;
+					_elastic->numCreated += 1;
+				}
+				_numQueues.store(numQueues + 1, std::memory_order_release);
+			}
+		} else if (occupancy <= LowOccupancy) {
+			_elastic->highSamples = 0;
+			if (++_elastic->lowSamples >= ShrinkSamples && numQueues > _elastic->minQueues) {
+				_elastic->lowSamples = 0;
+				_numQueues.store(numQueues - 1, std::memory_order_release);
+			}
+		} else {
+			_elastic->highSamples = 0;
+			_elastic->lowSamples = 0;
 		}
 	}
 
 	static inline bool isValidPolicy(policy_t policy)
 	{
 		return policy == GASPI_QUEUE_GROUP_POLICY_DEFAULT
-			|| policy == GASPI_QUEUE_GROUP_POLICY_CPU_RR;
+			|| policy == GASPI_QUEUE_GROUP_POLICY_CPU_RR
+			|| policy == GASPI_QUEUE_GROUP_POLICY_RANK;
 	}
 
 private:
 	struct QueueRange {
-		queue_id_t first;
+		number_t first;
 		number_t num;
 	};
 
-	inline void setupCPURoundRobinData(queue_id_t *assignationQueue)
+	inline void setupCPURoundRobinData(CPUQueueMap *map)
 	{
-		assert(assignationQueue != nullptr);
+		assert(map != nullptr);
 
+		const size_t numQueues = _queues.size();
 		const size_t maxCPUs = HardwareInfo::getMaxCPUs();
-		const size_t maxNUMAs = HardwareInfo::getMaxNUMANodes();
-		const size_t numNUMAs = HardwareInfo::getNumAvailableNUMANodes();
-
-		const std::vector<int> &cpuToNUMA = HardwareInfo::getCPUToNUMANode();
-		const std::vector<bool> &numaAvailability = HardwareInfo::getNUMANodeAvailability();
-
-		const size_t queuesPerNUMA = _numQueues / numNUMAs;
-		const size_t remainingQueues = _numQueues % numNUMAs;
-
-		QueueRange numaQueues[maxNUMAs];
-
-		/* Assigns distinct ranges of queues to NUMA nodes if possible */
-		if (_numQueues >= numNUMAs) {
-			queue_id_t queue = _firstQueue;
-			for (size_t numa = 0; numa < maxNUMAs; ++numa) {
-				/* Assign them to NUMAs which are being used by this rank */
-				if (numaAvailability[numa]) {
-					numaQueues[numa].first = queue;
-					numaQueues[numa].num = queuesPerNUMA + (numa < remainingQueues);
-					queue += numaQueues[numa].num;
-				}
-	    	}
+		const size_t numDomains = HardwareInfo::getNumLLCDomains();
+		const std::vector<int> &cpuToDomain = HardwareInfo::getCPUToLLCDomain();
+
+		std::vector<QueueRange> domainQueues(numDomains);
+
+		if (numQueues >= numDomains) {
+			/* Assigns distinct ranges of queues to LLC domains */
+			const size_t queuesPerDomain = numQueues / numDomains;
+			const size_t remainingQueues = numQueues % numDomains;
+
+			number_t offset = 0;
+			for (size_t domain = 0; domain < numDomains; ++domain) {
+				domainQueues[domain].first = offset;
+				domainQueues[domain].num = queuesPerDomain + (domain < remainingQueues);
+				offset += domainQueues[domain].num;
+			}
 		} else {
-			/* Assign one-to-one all queues, except the last, to the first NUMAs */
-			size_t numAssigned = 0, numa = 0;
-			while (numAssigned < remainingQueues - 1) {
-				if (numaAvailability[numa]) {
-					numaQueues[numa].first = (queue_id_t) numAssigned;
-					numaQueues[numa].num = 1;
-					++numAssigned;
-				}
+			/* Consecutive domains, which are close in the NUMA hierarchy, share queues */
+			for (size_t domain = 0; domain < numDomains; ++domain) {
+				domainQueues[domain].first = (domain * numQueues) / numDomains;
+				domainQueues[domain].num = 1;
 			}
-			assert(numAssigned < numNUMAs);
+		}
 
-			/* Assign the last queue to the rest of NUMAs */
-			for (numa = remainingQueues - 1; numa < maxNUMAs; ++numa) {
-				if (numaAvailability[numa]) {
-					numaQueues[numa].first = (queue_id_t) (remainingQueues - 1);
-					numaQueues[numa].num = 1;
-				}
+		/* Assigns the queues of each domain to its CPUs in Round-Robin */
+		std::vector<number_t> offsets(numDomains, 0);
+
+		map->systemOffsets.assign(maxCPUs, 0);
+		for (size_t cpu = 0; cpu < maxCPUs; ++cpu) {
+			const int domain = cpuToDomain[cpu];
+			if (domain >= 0) {
+				map->systemOffsets[cpu] = domainQueues[domain].first + offsets[domain];
+				offsets[domain] = (offsets[domain] + 1) % domainQueues[domain].num;
 			}
 		}
 
-		/* Assigns queues to CPUs in Round-Robin */
-		for (size_t numa = 0; numa < maxNUMAs; ++numa) {
-			if (numaAvailability[numa]) {
-				const number_t firstQueue = numaQueues[numa].first;
-				const number_t numQueues  = numaQueues[numa].num;
-				number_t offset = 0;
-
-				for (size_t cpu = 0; cpu < maxCPUs; ++cpu) {
-					if (cpuToNUMA[cpu] == (int) numa) {
-						assignationQueue[cpu] = firstQueue + offset;
-						offset = (offset + 1) % numQueues;
-					}
-				}
-			}
+		/* The logical CPU entries are resolved on their first use */
+		map->logicalOffsets = std::vector<std::atomic<int> >(TaskingModel::getNumCPUs());
+		for (std::atomic<int> &offset : map->logicalOffsets) {
+			std::atomic_init(&offset, -1);
 		}
 	}
 
@@ -171,13 +439,13 @@ private:
 		assert(_data != nullptr);
 
 		if (_policy == GASPI_QUEUE_GROUP_POLICY_DEFAULT) {
-			std::atomic<number_t> *counter = (std::atomic<number_t> *)_data;
-			assert(counter != nullptr);
-			delete counter;
-		} else {
-			queue_id_t *queueIDs = (queue_id_t *)_data;
-			assert(queueIDs != nullptr);
-			delete [] queueIDs;
+			Cursor *cursors = (Cursor *)_data;
+			assert(cursors != nullptr);
+			delete [] cursors;
+		} else if (_policy == GASPI_QUEUE_GROUP_POLICY_CPU_RR) {
+			CPUQueueMap *map = (CPUQueueMap *)_data;
+			assert(map != nullptr);
+			delete map;
 		}
 	}
 };
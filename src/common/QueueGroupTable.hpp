@@ -0,0 +1,165 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef QUEUE_GROUP_TABLE_HPP
+#define QUEUE_GROUP_TABLE_HPP
+
+#include <TAGASPI.h>
+
+#include "QueueGroup.hpp"
+#include "util/RCU.hpp"
+#include "util/SpinLock.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+
+namespace tagaspi {
+
+//! Table of queue groups indexed by their identifier. The table is split
+//! into chunks of slots that are allocated when an identifier of the chunk
+//! is first used. Lookups are wait-free and must be performed inside a RCU
+//! read-side critical section. Insertions and removals are serialized, and
+//! removed groups must be reclaimed after a RCU grace period
+class QueueGroupTable {
+private:
+	typedef gaspi_queue_group_id_t id_t;
+
+	static constexpr size_t Capacity = (size_t) std::numeric_limits<id_t>::max() + 1;
+	static constexpr size_t ChunkSize = 16;
+	static constexpr size_t NumChunks = (Capacity + ChunkSize - 1) / ChunkSize;
+
+	struct Chunk {
+		std::atomic<QueueGroup *> slots[ChunkSize];
+
+		Chunk()
+		{
+			for (size_t s = 0; s < ChunkSize; ++s) {
+				std::atomic_init(&slots[s], (QueueGroup *) nullptr);
+			}
+		}
+	};
+
+	std::atomic<Chunk *> _chunks[NumChunks];
+
+	//! The lock serializing the modifications
+	SpinLock _lock;
+
+public:
+	QueueGroupTable() :
+		_lock()
+	{
+		for (size_t c = 0; c < NumChunks; ++c) {
+			std::atomic_init(&_chunks[c], (Chunk *) nullptr);
+		}
+	}
+
+	~QueueGroupTable()
+	{
+		clear();
+	}
+
+	static constexpr size_t capacity()
+	{
+		return Capacity;
+	}
+
+	//! \brief Get a queue group or nullptr if it does not exist
+	inline QueueGroup *get(id_t id) const
+	{
+		Chunk *chunk = _chunks[id / ChunkSize].load(std::memory_order_acquire);
+		if (chunk == nullptr)
+			return nullptr;
+
+		return chunk->slots[id % ChunkSize].load(std::memory_order_acquire);
+	}
+
+	//! \brief Call a function for each queue group
+	//!
+	//! This function must be called inside a RCU read-side critical section
+	template <typename F>
+	inline void forEach(F function) const
+	{
+		for (size_t c = 0; c < NumChunks; ++c) {
+			Chunk *chunk = _chunks[c].load(std::memory_order_acquire);
+			if (chunk == nullptr)
+				continue;
+
+			for (size_t s = 0; s < ChunkSize; ++s) {
+				QueueGroup *queueGroup = chunk->slots[s].load(std::memory_order_acquire);
+				if (queueGroup != nullptr)
+					function(queueGroup);
+			}
+		}
+	}
+
+	//! \brief Insert a queue group
+	//!
+	//! \returns Whether it was inserted; false if the identifier is in use
+	inline bool insert(id_t id, QueueGroup *queueGroup)
+	{
+		assert(queueGroup != nullptr);
+
+		std::lock_guard<SpinLock> guard(_lock);
+
+		Chunk *chunk = _chunks[id / ChunkSize].load(std::memory_order_relaxed);
+		if (chunk == nullptr) {
+			chunk = new Chunk();
+			assert(chunk != nullptr);
+
+			_chunks[id / ChunkSize].store(chunk, std::memory_order_release);
+		}
+
+		std::atomic<QueueGroup *> &slot = chunk->slots[id % ChunkSize];
+		if (slot.load(std::memory_order_relaxed) != nullptr)
+			return false;
+
+		slot.store(queueGroup, std::memory_order_release);
+
+		return true;
+	}
+
+	//! \brief Unlink a queue group from the table
+	//!
+	//! The caller must wait for a RCU grace period before releasing it
+	//!
+	//! \returns The unlinked group or nullptr if it does not exist
+	inline QueueGroup *remove(id_t id)
+	{
+		std::lock_guard<SpinLock> guard(_lock);
+
+		Chunk *chunk = _chunks[id / ChunkSize].load(std::memory_order_relaxed);
+		if (chunk == nullptr)
+			return nullptr;
+
+		return chunk->slots[id % ChunkSize].exchange(nullptr);
+	}
+
+	//! \brief Release all groups and chunks
+	//!
+	//! There cannot be any concurrent access to the table
+	inline void clear()
+	{
+		for (size_t c = 0; c < NumChunks; ++c) {
+			Chunk *chunk = _chunks[c].exchange(nullptr);
+			if (chunk == nullptr)
+				continue;
+
+			for (size_t s = 0; s < ChunkSize; ++s) {
+				QueueGroup *queueGroup = chunk->slots[s].load();
+				if (queueGroup != nullptr)
+					delete queueGroup;
+			}
+			delete chunk;
+		}
+	}
+};
+
+} // namespace tagaspi
+
+#endif // QUEUE_GROUP_TABLE_HPP
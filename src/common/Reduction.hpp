@@ -0,0 +1,154 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef REDUCTION_HPP
+#define REDUCTION_HPP
+
+#include <GASPI.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace tagaspi {
+
+//! Class that combines the elements of two arrays with the reduction
+//! operations of GASPI. The kernels are plain loops over non-aliased
+//! arrays, which the compiler vectorizes for each type and operation
+class Reduction {
+private:
+	template <typename T>
+	struct Sum {
+		static inline T apply(T a, T b)
+		{
+			return a + b;
+		}
+	};
+
+	template <typename T>
+	struct Min {
+		static inline T apply(T a, T b)
+		{
+			return std::min(a, b);
+		}
+	};
+
+	template <typename T>
+	struct Max {
+		static inline T apply(T a, T b)
+		{
+			return std::max(a, b);
+		}
+	};
+
+	template <typename T, template <typename> class Op>
+	static inline void combine(
+		void *__restrict__ result,
+		const void *__restrict__ first,
+		const void *__restrict__ second,
+		size_t num
+	) {
+		T *__restrict__ r = static_cast<T *>(result);
+		const T *__restrict__ a = static_cast<const T *>(first);
+		const T *__restrict__ b = static_cast<const T *>(second);
+
+		for (size_t e = 0; e < num; ++e)
+			r[e] = Op<T>::apply(a[e], b[e]);
+	}
+
+	template <typename T>
+	static inline void combine(
+		gaspi_operation_t operation,
+		void *result,
+		const void *first,
+		const void *second,
+		size_t num
+	) {
+		switch (operation) {
+			case GASPI_OP_MIN:
+				combine<T, Min>(result, first, second, num);
+				break;
+			case GASPI_OP_MAX:
+				combine<T, Max>(result, first, second, num);
+				break;
+			case GASPI_OP_SUM:
+				combine<T, Sum>(result, first, second, num);
+				break;
+			default:
+				assert(false);
+		}
+	}
+
+public:
+	//! \brief Check whether an operation and a type are supported
+	static inline bool isValid(gaspi_operation_t operation, gaspi_datatype_t type)
+	{
+		if (operation != GASPI_OP_MIN && operation != GASPI_OP_MAX && operation != GASPI_OP_SUM)
+			return false;
+		return (getTypeSize(type) > 0);
+	}
+
+	//! \brief Get the size in bytes of a type or zero if not supported
+	static inline size_t getTypeSize(gaspi_datatype_t type)
+	{
+		switch (type) {
+			case GASPI_TYPE_INT:
+				return sizeof(int);
+			case GASPI_TYPE_UINT:
+				return sizeof(unsigned int);
+			case GASPI_TYPE_FLOAT:
+				return sizeof(float);
+			case GASPI_TYPE_DOUBLE:
+				return sizeof(double);
+			case GASPI_TYPE_LONG:
+				return sizeof(long);
+			case GASPI_TYPE_ULONG:
+				return sizeof(unsigned long);
+			default:
+				return 0;
+		}
+	}
+
+	//! \brief Combine two arrays into a third one, which cannot overlap them
+	//!
+	//! The combination is commutative, so all ranks combining the same
+	//! pair of arrays obtain the same result regardless of their order
+	static inline void reduce(
+		gaspi_operation_t operation,
+		gaspi_datatype_t type,
+		void *result,
+		const void *first,
+		const void *second,
+		size_t num
+	) {
+		switch (type) {
+			case GASPI_TYPE_INT:
+				combine<int>(operation, result, first, second, num);
+				break;
+			case GASPI_TYPE_UINT:
+				combine<unsigned int>(operation, result, first, second, num);
+				break;
+			case GASPI_TYPE_FLOAT:
+				combine<float>(operation, result, first, second, num);
+				break;
+			case GASPI_TYPE_DOUBLE:
+				combine<double>(operation, result, first, second, num);
+				break;
+			case GASPI_TYPE_LONG:
+				combine<long>(operation, result, first, second, num);
+				break;
+			case GASPI_TYPE_ULONG:
+				combine<unsigned long>(operation, result, first, second, num);
+				break;
+			default:
+				assert(false);
+		}
+	}
+};
+
+} // namespace tagaspi
+
+#endif // REDUCTION_HPP
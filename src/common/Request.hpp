@@ -0,0 +1,143 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef REQUEST_HPP
+#define REQUEST_HPP
+
+#include "Completion.hpp"
+#include "TaskingModel.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace tagaspi {
+
+//! Completion object behind a request handle, which lets a task follow
+//! the completion of an operation instead of binding it to the task. The
+//! owner of the handle either tests the request until it completes or
+//! binds it to a task event or a callback. These release the object,
+//! which cannot be accessed afterwards. Requests not tied to operations
+//! hold one pending request that their owner discounts
+class Request : public Completion {
+private:
+	//! The state of the request
+	enum State {
+		//! The operation is in flight and nobody waits for it
+		PENDING = 0,
+		//! The operation is in flight and a task or callback waits for it
+		WAITING,
+		//! The operation has completed
+		COMPLETED,
+	};
+
+	std::atomic<int> _state;
+
+	//! The task waiting for the request, if any
+	TaskingModel::task_handle_t _task;
+
+	//! The callback waiting for the request, if any
+	TaskingModel::task_function_t _callback;
+	void *_callbackArgs;
+
+	inline void complete() override
+	{
+		int state = _state.exchange(COMPLETED, std::memory_order_acq_rel);
+		assert(state != COMPLETED);
+
+		// Otherwise, the owner releases the object when testing it
+		if (state == WAITING) {
+			if (_callback != nullptr)
+				_callback(_callbackArgs);
+			else
+				TaskingModel::decreaseTaskEvents(_task, 1);
+			delete this;
+		}
+	}
+
+	//! \brief Register the waiter set by the caller
+	//!
+	//! \returns Whether the waiter was registered before the completion
+	inline bool wait()
+	{
+		int expected = PENDING;
+		if (_state.compare_exchange_strong(expected, WAITING, std::memory_order_acq_rel))
+			return true;
+
+		assert(expected == COMPLETED);
+		return false;
+	}
+
+public:
+	//! \brief Create a request for an operation
+	//!
+	//! The requests of the operation must be accounted before posting it
+	inline Request(uint64_t pending) :
+		Completion(pending),
+		_state(PENDING),
+		_task(nullptr),
+		_callback(nullptr),
+		_callbackArgs(nullptr)
+	{
+		assert(pending > 0);
+	}
+
+	//! \brief Check whether the operation has completed
+	//!
+	//! \returns Whether the request completed and was released
+	inline bool test()
+	{
+		if (_state.load(std::memory_order_acquire) != COMPLETED)
+			return false;
+
+		delete this;
+		return true;
+	}
+
+	//! \brief Bind the request to an event of a task
+	//!
+	//! The event is released once the operation completes, and then the
+	//! request is released. If it has already completed, it is released
+	//! without registering any event
+	inline void bind(TaskingModel::task_handle_t task)
+	{
+		assert(task != nullptr);
+
+		// The event must be registered before the operation may complete
+		_task = task;
+		TaskingModel::increaseCurrentTaskEvents(task, 1);
+
+		if (!wait()) {
+			TaskingModel::decreaseTaskEvents(task, 1);
+			delete this;
+		}
+	}
+
+	//! \brief Bind the request to a callback
+	//!
+	//! The callback runs from the polling instance that completes the
+	//! operation, and then the request is released. If it has already
+	//! completed, it is released without running the callback
+	//!
+	//! \returns Whether the callback was registered
+	inline bool bind(TaskingModel::task_function_t callback, void *args)
+	{
+		assert(callback != nullptr);
+
+		_callback = callback;
+		_callbackArgs = args;
+
+		if (!wait()) {
+			delete this;
+			return false;
+		}
+		return true;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // REQUEST_HPP
@@ -0,0 +1,184 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "SplitList.hpp"
+#include "util/ErrorHandler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+
+namespace tagaspi {
+
+std::deque<SplitList::PendingList *> SplitList::_pending;
+SpinLock SplitList::_pendingLock;
+std::atomic<uint64_t> SplitList::_numPending(0);
+
+gaspi_number_t SplitList::getRequests(const PendingList *operation, gaspi_number_t first)
+{
+	const gaspi_number_t num = operation->size.size();
+	assert(first <= num);
+
+	gaspi_number_t requests = 0;
+	while (first < num) {
+		gaspi_number_t entries = std::min(operation->chunkEntries, num - first);
+		gaspi_number_t chunkRequests = 0;
+
+		gaspi_return_t eret = gaspi_operation_get_num_requests(operation->type, entries, &chunkRequests);
+		assert(eret == GASPI_SUCCESS);
+		UNUSED_VARIABLE(eret);
+
+		requests += chunkRequests;
+		first += entries;
+	}
+	return requests;
+}
+
+gaspi_return_t SplitList::submitChunks(PendingList *operation)
+{
+	assert(operation != nullptr);
+
+	const gaspi_number_t num = operation->size.size();
+	const gaspi_tag_t tag = operation->completion->getTag();
+
+	while (operation->next < num) {
+		const gaspi_number_t next = operation->next;
+		const gaspi_number_t entries = std::min(operation->chunkEntries, num - next);
+
+		gaspi_return_t eret = gaspi_operation_list_submit(operation->type, tag,
+					entries, &operation->segmentLocal[next], &operation->offsetLocal[next],
+					operation->rank, &operation->segmentRemote[next], &operation->offsetRemote[next],
+					&operation->size[next], 0, 0, 0, operation->queue, GASPI_TEST);
+		if (eret == GASPI_TIMEOUT || eret == GASPI_QUEUE_FULL)
+			return GASPI_QUEUE_FULL;
+		if (eret != GASPI_SUCCESS)
+			return eret;
+
+		// The completion cannot finish before submitting all chunks
+		operation->next += entries;
+	}
+	return GASPI_SUCCESS;
+}
+
+gaspi_return_t SplitList::submit(
+	TaskingModel::task_handle_t task,
+	gaspi_operation_type_t type,
+	const OperationList &list,
+	gaspi_rank_t rank,
+	gaspi_segment_id_t segmentNotification,
+	gaspi_notification_id_t notificationId,
+	gaspi_notification_t notificationValue,
+	gaspi_queue_id_t queue
+) {
+	assert(type == GASPI_OP_WRITE_LIST || type == GASPI_OP_READ_LIST
+		|| type == GASPI_OP_WRITE_LIST_NOTIFY || type == GASPI_OP_READ_LIST_NOTIFY);
+	assert(list.num > 0);
+
+	// The notification is posted once all chunks have completed
+	const bool notify = (type == GASPI_OP_WRITE_LIST_NOTIFY || type == GASPI_OP_READ_LIST_NOTIFY);
+
+	PendingList *operation = new PendingList();
+	assert(operation != nullptr);
+
+	if (type == GASPI_OP_WRITE_LIST_NOTIFY)
+		operation->type = GASPI_OP_WRITE_LIST;
+	else if (type == GASPI_OP_READ_LIST_NOTIFY)
+		operation->type = GASPI_OP_READ_LIST;
+	else
+		operation->type = type;
+	operation->rank = rank;
+	operation->queue = queue;
+	operation->segmentLocal.assign(list.segmentLocal, list.segmentLocal + list.num);
+	operation->offsetLocal.assign(list.offsetLocal, list.offsetLocal + list.num);
+	operation->segmentRemote.assign(list.segmentRemote, list.segmentRemote + list.num);
+	operation->offsetRemote.assign(list.offsetRemote, list.offsetRemote + list.num);
+	operation->size.assign(list.size, list.size + list.num);
+	operation->next = 0;
+
+	// Chunks take at most a quarter of the queue
+	gaspi_number_t entryRequests = 0;
+	gaspi_return_t eret = gaspi_operation_get_num_requests(operation->type, 1, &entryRequests);
+	assert(eret == GASPI_SUCCESS);
+	assert(entryRequests > 0);
+
+	operation->chunkEntries = std::max<gaspi_number_t>((_env.queueSizeMax / 4) / entryRequests, 1);
+
+	const gaspi_number_t numRequests = getRequests(operation, 0);
+
+	// A single event for all chunks plus the requests of the notification
+	uint64_t numEvents = 1;
+	if (notify)
+		numEvents += _env.numRequests[Operation::NOTIFY];
+
+	TaskingModel::increaseCurrentTaskEvents(task, numEvents);
+
+	operation->completion = new ChunkedCompletion(numRequests, task, notify,
+		segmentNotification, rank, notificationId, notificationValue, queue);
+	assert(operation->completion != nullptr);
+
+	std::unique_lock<SpinLock> guard(_pendingLock);
+
+	// Keep the submission order of the split lists
+	if (!_pending.empty()) {
+		_pending.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_release);
+		return GASPI_SUCCESS;
+	}
+
+	eret = submitChunks(operation);
+	if (eret == GASPI_QUEUE_FULL) {
+		_pending.push_back(operation);
+		_numPending.fetch_add(1, std::memory_order_release);
+		return GASPI_SUCCESS;
+	}
+	guard.unlock();
+
+	if (eret != GASPI_SUCCESS) {
+		// Discount the chunks that were not submitted
+		ChunkedCompletion *completion = operation->completion;
+		gaspi_number_t remaining = getRequests(operation, operation->next);
+
+		delete operation;
+
+		completion->fail();
+		completion->decrease(remaining);
+		return eret;
+	}
+
+	delete operation;
+
+	return GASPI_SUCCESS;
+}
+
+void SplitList::progress()
+{
+	if (!_pendingLock.trylock())
+		return;
+
+	while (!_pending.empty()) {
+		PendingList *operation = _pending.front();
+		assert(operation != nullptr);
+
+		gaspi_return_t eret = submitChunks(operation);
+		if (eret == GASPI_QUEUE_FULL)
+			break;
+
+		ErrorHandler::failIf(eret != GASPI_SUCCESS,
+			"Return code ", (int) eret, " when posting a chunk of a split list");
+
+		_pending.pop_front();
+		_numPending.fetch_sub(1, std::memory_order_relaxed);
+
+		delete operation;
+	}
+
+	_pendingLock.unlock();
+}
+
+} // namespace tagaspi
@@ -0,0 +1,118 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef SPLIT_LIST_HPP
+#define SPLIT_LIST_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "ChunkedCompletion.hpp"
+#include "Environment.hpp"
+#include "OperationList.hpp"
+#include "TaskingModel.hpp"
+#include "util/SpinLock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that submits list operations that do not fit in the free space
+//! of their queue. The list is split into chunks, which are submitted as
+//! long as the queue has space. The remaining chunks are submitted by the
+//! polling instances as the queue drains. All chunks complete as a single
+//! event of the calling task, and the notification of write-notify lists
+//! is posted once all chunks have completed
+class SplitList {
+private:
+	//! A split list with chunks pending to submit
+	struct PendingList {
+		gaspi_operation_type_t type;
+		gaspi_rank_t rank;
+		gaspi_queue_id_t queue;
+		ChunkedCompletion *completion;
+
+		//! The entries copied from the caller
+		std::vector<gaspi_segment_id_t> segmentLocal;
+		std::vector<gaspi_offset_t> offsetLocal;
+		std::vector<gaspi_segment_id_t> segmentRemote;
+		std::vector<gaspi_offset_t> offsetRemote;
+		std::vector<gaspi_size_t> size;
+
+		//! The first entry not submitted yet and the entries per chunk
+		gaspi_number_t next;
+		gaspi_number_t chunkEntries;
+	};
+
+	//! The operations with pending chunks in submission order
+	static std::deque<PendingList *> _pending;
+
+	//! The lock protecting the pending operations
+	static SpinLock _pendingLock;
+
+	static std::atomic<uint64_t> _numPending;
+
+	//! \brief Submit the pending chunks of an operation while there is space
+	//!
+	//! \returns GASPI_SUCCESS if all chunks were submitted, GASPI_QUEUE_FULL
+	//!          if the queue has no space, or the error of the submission
+	static gaspi_return_t submitChunks(PendingList *operation);
+
+	//! \brief Get the requests of the chunks from an entry until the end
+	static gaspi_number_t getRequests(const PendingList *operation, gaspi_number_t first);
+
+public:
+	//! \brief Check whether a list operation must be split
+	//!
+	//! \param numRequests The requests of the whole list
+	//! \param queue The queue of the operation
+	static inline bool mustSplit(gaspi_number_t numRequests, gaspi_queue_id_t queue)
+	{
+		if (numRequests > _env.queueSizeMax)
+			return true;
+
+		gaspi_number_t queueSize = 0;
+		if (gaspi_queue_size(queue, &queueSize) != GASPI_SUCCESS)
+			return false;
+
+		queueSize = std::min(queueSize, _env.queueSizeMax);
+
+		return (numRequests > _env.queueSizeMax - queueSize);
+	}
+
+	//! \brief Split and submit a list operation
+	//!
+	//! The task events are increased and decreased by this function
+	//!
+	//! \param type The list operation, which may be a write or read list with
+	//!             notification. The notification is posted to the remote rank
+	static gaspi_return_t submit(
+		TaskingModel::task_handle_t task,
+		gaspi_operation_type_t type,
+		const OperationList &list,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentNotification,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_id_t queue
+	);
+
+	//! \brief Submit the pending chunks while there is space in the queues
+	static void progress();
+
+	static inline bool hasPending()
+	{
+		return _numPending.load(std::memory_order_acquire) > 0;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // SPLIT_LIST_HPP
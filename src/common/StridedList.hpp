@@ -0,0 +1,172 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef STRIDED_LIST_HPP
+#define STRIDED_LIST_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+
+#include "OperationList.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace tagaspi {
+
+//! Class that expands strided transfers into list operations. A strided
+//! transfer of N dimensions is described by N counts and two arrays of N-1
+//! strides, one for each side. The first count is the size in bytes of the
+//! contiguous blocks. The count d > 0 is the number of repetitions along
+//! the dimension d, which are separated by the stride d-1 in bytes. The
+//! lists are cached per thread, so repeated transfers reuse the descriptors
+//! instead of generating them again
+class StridedList {
+private:
+	typedef std::vector<uint64_t> Key;
+
+	struct KeyHash {
+		inline size_t operator()(const Key &key) const
+		{
+			size_t hash = key.size();
+			for (uint64_t value : key)
+				hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+
+	//! The descriptors of an expanded transfer
+	struct Descriptors {
+		std::vector<gaspi_segment_id_t> segmentLocal;
+		std::vector<gaspi_offset_t> offsetLocal;
+		std::vector<gaspi_segment_id_t> segmentRemote;
+		std::vector<gaspi_offset_t> offsetRemote;
+		std::vector<gaspi_size_t> size;
+	};
+
+	typedef std::unordered_map<Key, Descriptors, KeyHash> Cache;
+
+	//! The maximum number of cached transfers per thread
+	static constexpr size_t MaxCachedTransfers = 128;
+
+	static thread_local Cache _cache;
+
+	//! \brief Generate the descriptors of a transfer merging contiguous blocks
+	static inline void generate(
+		Descriptors &descriptors,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		const gaspi_size_t *stridesLocal,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		const gaspi_size_t *stridesRemote,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		const gaspi_size_t blockSize = counts[0];
+		std::vector<gaspi_size_t> index(dims, 0);
+
+		bool done = false;
+		while (!done) {
+			gaspi_offset_t local = offsetLocal;
+			gaspi_offset_t remote = offsetRemote;
+			for (gaspi_number_t d = 1; d < dims; ++d) {
+				local += index[d] * stridesLocal[d - 1];
+				remote += index[d] * stridesRemote[d - 1];
+			}
+
+			// Extend the previous block if both sides are contiguous
+			const size_t last = descriptors.size.size();
+			if (last > 0
+					&& descriptors.offsetLocal[last - 1] + descriptors.size[last - 1] == local
+					&& descriptors.offsetRemote[last - 1] + descriptors.size[last - 1] == remote) {
+				descriptors.size[last - 1] += blockSize;
+			} else {
+				descriptors.segmentLocal.push_back(segmentLocal);
+				descriptors.offsetLocal.push_back(local);
+				descriptors.segmentRemote.push_back(segmentRemote);
+				descriptors.offsetRemote.push_back(remote);
+				descriptors.size.push_back(blockSize);
+			}
+
+			// Advance the index of the dimensions, the first one fastest
+			done = true;
+			for (gaspi_number_t d = 1; d < dims; ++d) {
+				if (++index[d] < counts[d]) {
+					done = false;
+					break;
+				}
+				index[d] = 0;
+			}
+		}
+	}
+
+public:
+	//! \brief Check whether a transfer moves any data
+	static inline bool isEmpty(gaspi_number_t dims, const gaspi_size_t *counts)
+	{
+		for (gaspi_number_t d = 0; d < dims; ++d) {
+			if (counts[d] == 0)
+				return true;
+		}
+		return false;
+	}
+
+	//! \brief Get the list of a strided transfer
+	//!
+	//! The returned list is valid until the next call of the same thread
+	static inline OperationList get(
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		const gaspi_size_t *stridesLocal,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		const gaspi_size_t *stridesRemote,
+		gaspi_number_t dims,
+		const gaspi_size_t *counts
+	) {
+		assert(dims > 0);
+		assert(!isEmpty(dims, counts));
+
+		Key key;
+		key.reserve(4 + 3 * dims);
+		key.push_back(segmentLocal);
+		key.push_back(offsetLocal);
+		key.push_back(segmentRemote);
+		key.push_back(offsetRemote);
+		key.insert(key.end(), counts, counts + dims);
+		key.insert(key.end(), stridesLocal, stridesLocal + dims - 1);
+		key.insert(key.end(), stridesRemote, stridesRemote + dims - 1);
+
+		Cache &cache = _cache;
+
+		Cache::iterator it = cache.find(key);
+		if (it == cache.end()) {
+			// Drop the cached transfers of other phases of the application
+			if (cache.size() >= MaxCachedTransfers)
+				cache.clear();
+
+			it = cache.emplace(std::move(key), Descriptors()).first;
+			generate(it->second, segmentLocal, offsetLocal, stridesLocal,
+				segmentRemote, offsetRemote, stridesRemote, dims, counts);
+		}
+
+		Descriptors &descriptors = it->second;
+
+		return OperationList(descriptors.size.size(),
+			descriptors.segmentLocal.data(), descriptors.offsetLocal.data(),
+			descriptors.segmentRemote.data(), descriptors.offsetRemote.data(),
+			descriptors.size.data());
+	}
+};
+
+} // namespace tagaspi
+
+#endif // STRIDED_LIST_HPP
@@ -0,0 +1,123 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef STRIPING_HPP
+#define STRIPING_HPP
+
+#include <GASPI.h>
+#include <GASPI_Lowlevel.h>
+#include <TAGASPI.h>
+
+#include "ChunkedCompletion.hpp"
+#include "Environment.hpp"
+#include "QueueGroup.hpp"
+#include "TaskingModel.hpp"
+#include "util/RCU.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+namespace tagaspi {
+
+//! Class that splits large transfers into chunks across the queues of a
+//! queue group. All chunks complete as a single event of the calling task
+class Striping {
+public:
+	static inline gaspi_return_t submit(
+		gaspi_operation_type_t operation,
+		gaspi_segment_id_t segmentLocal,
+		gaspi_offset_t offsetLocal,
+		gaspi_rank_t rank,
+		gaspi_segment_id_t segmentRemote,
+		gaspi_offset_t offsetRemote,
+		gaspi_size_t size,
+		bool notify,
+		gaspi_notification_id_t notificationId,
+		gaspi_notification_t notificationValue,
+		gaspi_queue_group_id_t queueGroupId
+	) {
+		assert(operation == GASPI_OP_WRITE || operation == GASPI_OP_READ);
+		assert(!notify || operation == GASPI_OP_WRITE);
+		assert(queueGroupId < _env.maxQueueGroups);
+
+		// Prevent the group from being released while in use
+		util::RCUReadGuard guard;
+
+		QueueGroup *queueGroup = _env.queueGroups.get(queueGroupId);
+		if (queueGroup == nullptr) {
+			fprintf(stderr, "Error: Queue group %d does not exist\n", queueGroupId);
+			return GASPI_ERROR;
+		}
+
+		QueueGroup *subgroup = queueGroup->getSubgroup(size);
+		assert(subgroup != nullptr);
+
+		gaspi_number_t numQueues = subgroup->getNumQueues();
+		assert(numQueues > 0);
+
+		// Start at the queue chosen by the group policy
+		gaspi_number_t startOffset = subgroup->getOffset(rank) % numQueues;
+		gaspi_queue_id_t startQueue = subgroup->getQueueAt(startOffset);
+
+		// Avoid chunks smaller than the minimum chunk size
+		gaspi_number_t numChunks = numQueues;
+		if (_env.stripingMinChunkSize > 0) {
+			gaspi_size_t maxChunks = std::max<gaspi_size_t>(size / _env.stripingMinChunkSize, 1);
+			numChunks = std::min<gaspi_size_t>(numQueues, maxChunks);
+		}
+
+		const gaspi_size_t chunkSize = size / numChunks;
+		const gaspi_size_t remainder = size % numChunks;
+
+		gaspi_number_t numRequests = (operation == GASPI_OP_READ) ?
+			_env.numRequests[Operation::READ] : _env.numRequests[Operation::WRITE];
+		assert(numRequests > 0);
+
+		TaskingModel::task_handle_t task = TaskingModel::getCurrentTask();
+		assert(task != NULL);
+
+		// A single event for all chunks plus the requests of the notification
+		uint64_t numEvents = 1;
+		if (notify)
+			numEvents += _env.numRequests[Operation::NOTIFY];
+
+		TaskingModel::increaseCurrentTaskEvents(task, numEvents);
+
+		ChunkedCompletion *completion = new ChunkedCompletion(
+			numChunks * numRequests, task, notify, segmentRemote,
+			rank, notificationId, notificationValue, startQueue);
+		assert(completion != nullptr);
+
+		gaspi_tag_t tag = completion->getTag();
+		gaspi_offset_t offset = 0;
+
+		for (gaspi_number_t c = 0; c < numChunks; ++c) {
+			gaspi_queue_id_t queue = subgroup->getQueueAt((startOffset + c) % numQueues);
+			gaspi_size_t chunk = chunkSize + (c < remainder);
+
+			gaspi_return_t eret = gaspi_operation_submit(operation, tag,
+						segmentLocal, offsetLocal + offset, rank,
+						segmentRemote, offsetRemote + offset, chunk,
+						0, 0, queue, GASPI_BLOCK);
+			assert(eret != GASPI_TIMEOUT);
+
+			if (eret != GASPI_SUCCESS) {
+				// Discount the chunks that were not submitted
+				completion->fail();
+				completion->decrease((numChunks - c) * numRequests);
+				return eret;
+			}
+			offset += chunk;
+		}
+
+		return GASPI_SUCCESS;
+	}
+};
+
+} // namespace tagaspi
+
+#endif // STRIPING_HPP
@@ -19,6 +19,9 @@ void TaskingModel::initialize()
 	_alpi_task_waitfor_ns.load();
 	_alpi_task_events_increase.load();
 	_alpi_task_events_decrease.load();
+	_alpi_cpu_count.load();
+	_alpi_cpu_logical_id.load();
+	_alpi_cpu_system_id.load();
 
 	int expected[2] = { ALPI_VERSION_MAJOR, ALPI_VERSION_MINOR };
 	int provided[2];
@@ -59,4 +62,13 @@ TaskingModel::_alpi_task_waitfor_ns("alpi_task_waitfor_ns");
 Symbol<TaskingModel::alpi_task_spawn_t>
 TaskingModel::_alpi_task_spawn("alpi_task_spawn");
 
+Symbol<TaskingModel::alpi_cpu_count_t>
+TaskingModel::_alpi_cpu_count("alpi_cpu_count");
+
+Symbol<TaskingModel::alpi_cpu_logical_id_t>
+TaskingModel::_alpi_cpu_logical_id("alpi_cpu_logical_id");
+
+Symbol<TaskingModel::alpi_cpu_system_id_t>
+TaskingModel::_alpi_cpu_system_id("alpi_cpu_system_id");
+
 } // namespace tagaspi
@@ -24,6 +24,7 @@ class TaskingModel {
 public:
 	typedef struct alpi_task *task_handle_t;
 	typedef uint64_t (*polling_function_t)(void *args);
+	typedef void (*task_function_t)(void *args);
 
 	//! Structure that stores information regarding a polling instance
 	struct PollingInstance {
@@ -50,6 +51,9 @@ private:
 	using alpi_task_events_decrease_t = SymbolDecl<int, struct alpi_task *, uint64_t>;
 	using alpi_task_waitfor_ns_t = SymbolDecl<int, uint64_t, uint64_t *>;
 	using alpi_task_spawn_t = SymbolDecl<int, void (*)(void *), void *, void (*)(void *), void *, const char *, const struct alpi_attr *>;
+	using alpi_cpu_count_t = SymbolDecl<int, uint64_t *>;
+	using alpi_cpu_logical_id_t = SymbolDecl<int, uint64_t *>;
+	using alpi_cpu_system_id_t = SymbolDecl<int, uint64_t *>;
 
 	//! The symbols of the tasking model functions
 	static Symbol<alpi_error_string_t> _alpi_error_string;
@@ -60,6 +64,9 @@ private:
 	static Symbol<alpi_task_events_decrease_t> _alpi_task_events_decrease;
 	static Symbol<alpi_task_waitfor_ns_t> _alpi_task_waitfor_ns;
 	static Symbol<alpi_task_spawn_t> _alpi_task_spawn;
+	static Symbol<alpi_cpu_count_t> _alpi_cpu_count;
+	static Symbol<alpi_cpu_logical_id_t> _alpi_cpu_logical_id;
+	static Symbol<alpi_cpu_system_id_t> _alpi_cpu_system_id;
 
 public:
 	//! \brief Initialize and load the symbols of the tasking model
@@ -122,6 +129,22 @@ public:
 		delete instance;
 	}
 
+	//! \brief Spawn a task that runs a function once
+	//!
+	//! The function is responsible for releasing its argument
+	//!
+	//! \param name The name of the task
+	//! \param function The function to run
+	//! \param args The argument of the function
+	static void spawnTask(const char *name, task_function_t function, void *args)
+	{
+		int err = _alpi_task_spawn(
+			function, args, genericSpawnedCompleted, nullptr,
+			name, nullptr);
+		if (err)
+			ErrorHandler::fail("Failed alpi_task_spawn: ", getError(err));
+	}
+
 	//! \brief Get the current task handle
 	static task_handle_t getCurrentTask()
 	{
@@ -152,6 +175,38 @@ public:
 			ErrorHandler::fail("Failed alpi_task_events_decrease: ", getError(err));
 	}
 
+	//! \brief Get the number of CPUs available to the tasking runtime
+	static uint64_t getNumCPUs()
+	{
+		uint64_t count;
+		if (int err = _alpi_cpu_count(&count))
+			ErrorHandler::fail("Failed alpi_cpu_count: ", getError(err));
+
+		return count;
+	}
+
+	//! \brief Get the logical id of the CPU running the current task
+	//!
+	//! The logical ids are dense and within the range [0, getNumCPUs())
+	static uint64_t getCurrentLogicalCPU()
+	{
+		uint64_t logicalId;
+		if (int err = _alpi_cpu_logical_id(&logicalId))
+			ErrorHandler::fail("Failed alpi_cpu_logical_id: ", getError(err));
+
+		return logicalId;
+	}
+
+	//! \brief Get the system id of the CPU running the current task
+	static uint64_t getCurrentSystemCPU()
+	{
+		uint64_t systemId;
+		if (int err = _alpi_cpu_system_id(&systemId))
+			ErrorHandler::fail("Failed alpi_cpu_system_id: ", getError(err));
+
+		return systemId;
+	}
+
 private:
 	//! \brief Wrapper function called by all polling tasks
 	//!
@@ -190,6 +245,11 @@ private:
 		instance->_finished = true;
 	}
 
+	//! \brief Function called when a spawned task is completed
+	static void genericSpawnedCompleted(void *)
+	{
+	}
+
 	//! \brief Get the string describing the alpi error
 	//!
 	//! \param error The error code
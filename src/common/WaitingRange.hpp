@@ -31,6 +31,14 @@ protected:
 
 	TaskingModel::task_handle_t _task;
 
+	//! The optional function to run in a new task once notified, which
+	//! becomes responsible for releasing the event of the task
+	TaskingModel::task_function_t _action;
+	void *_actionArgs;
+
+	//! Whether the function runs directly from the polling instance
+	bool _inlineAction;
+
 public:
 	typedef boost::intrusive::link_mode<boost::intrusive::normal_link> link_mode_t;
 	typedef boost::intrusive::list_member_hook<link_mode_t> links_t;
@@ -43,14 +51,20 @@ public:
 		gaspi_number_t numNotifications,
 		gaspi_notification_t *notifiedValues,
 		gaspi_number_t remainingNotifications,
-		TaskingModel::task_handle_t task
+		TaskingModel::task_handle_t task,
+		TaskingModel::task_function_t action = nullptr,
+		void *actionArgs = nullptr,
+		bool inlineAction = false
 	) :
 		_segment(segment),
 		_firstId(firstNotificationId),
 		_numIds(numNotifications),
 		_notifiedValues(notifiedValues),
 		_remaining(remainingNotifications),
-		_task(task)
+		_task(task),
+		_action(action),
+		_actionArgs(actionArgs),
+		_inlineAction(inlineAction)
 	{
 	}
 
@@ -151,7 +165,12 @@ public:
 
 	inline void complete()
 	{
-		TaskingModel::decreaseTaskEvents(_task, 1);
+		if (_action != nullptr && _inlineAction)
+			_action(_actionArgs);
+		else if (_action != nullptr)
+			TaskingModel::spawnTask("TAGASPI NOTIFICATION ACTION", _action, _actionArgs);
+		else
+			TaskingModel::decreaseTaskEvents(_task, 1);
 	}
 };
 
@@ -0,0 +1,121 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef RCU_HPP
+#define RCU_HPP
+
+#include "Utils.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace tagaspi {
+namespace util {
+
+//! Class implementing a minimal read-copy-update mechanism. Readers
+//! announce their critical sections in a per-thread record, so entering
+//! and leaving them does not write any shared cache line. Writers unlink
+//! objects and wait for a grace period before reclaiming them
+class RCU {
+private:
+	struct alignas(CACHELINE_SIZE) Record {
+		//! The epoch in which the thread entered; zero when quiescent
+		std::atomic<uint64_t> epoch;
+
+		//! The next record in the list of records
+		Record *next;
+
+		Record() : epoch(0), next(nullptr)
+		{
+		}
+	};
+
+	//! The list of per-thread records, which are never released
+	static std::atomic<Record *> _records;
+
+	//! The current epoch, which starts at one
+	static std::atomic<uint64_t> _epoch;
+
+	//! The record of the current thread
+	static thread_local Record *_record;
+
+	static inline Record *registerThread()
+	{
+		Record *record = new Record();
+		assert(record != nullptr);
+
+		Record *head = _records.load(std::memory_order_relaxed);
+		do {
+			record->next = head;
+		} while (!_records.compare_exchange_weak(head, record,
+				std::memory_order_release, std::memory_order_relaxed));
+
+		_record = record;
+		return record;
+	}
+
+public:
+	//! \brief Enter a read-side critical section
+	//!
+	//! Read-side critical sections cannot be nested
+	static inline void readLock()
+	{
+		Record *record = (_record != nullptr) ? _record : registerThread();
+		assert(record->epoch.load(std::memory_order_relaxed) == 0);
+
+		record->epoch.store(_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	//! \brief Leave a read-side critical section
+	static inline void readUnlock()
+	{
+		assert(_record != nullptr);
+		_record->epoch.store(0, std::memory_order_release);
+	}
+
+	//! \brief Wait until all read-side critical sections that could
+	//! have observed the objects unlinked by the caller have finished
+	static inline void synchronize()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		const uint64_t target = _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+		Record *record = _records.load(std::memory_order_acquire);
+		while (record != nullptr) {
+			uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+			while (epoch != 0 && epoch < target) {
+				spinWait();
+				epoch = record->epoch.load(std::memory_order_acquire);
+			}
+			record = record->next;
+		}
+	}
+};
+
+//! Class that holds a read-side critical section in its scope
+class RCUReadGuard {
+public:
+	inline RCUReadGuard()
+	{
+		RCU::readLock();
+	}
+
+	inline ~RCUReadGuard()
+	{
+		RCU::readUnlock();
+	}
+
+	RCUReadGuard(const RCUReadGuard &) = delete;
+	RCUReadGuard &operator=(const RCUReadGuard &) = delete;
+};
+
+} // namespace util
+} // namespace tagaspi
+
+#endif // RCU_HPP
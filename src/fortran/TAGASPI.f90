@@ -20,15 +20,23 @@ module TAGASPI
 
     enum, bind(C) !:: gaspi_queue_group_policy_t
         ! Distribution of the queues using round-robin.
-        ! Each call gets a different queue.
+        ! Consecutive calls from the same CPU get different
+        ! queues. Each CPU starts at a different queue.
         enumerator :: GASPI_QUEUE_GROUP_POLICY_DEFAULT = 0
         ! Distribution of the queues across CPUs using
         ! round-robin. Each CPU will always get the same
         ! queue. If the number of CPUs exceeds the number of
         ! queues, the queues are distributed in a round-robin
         ! way. This policy avoids assigning the same queue to
-        ! CPUs that are in different NUMA nodes.
+        ! CPUs that do not share the last-level cache, unless
+        ! there are fewer queues than cache domains.
         enumerator :: GASPI_QUEUE_GROUP_POLICY_CPU_RR = 1
+        ! Distribution of the queues by destination rank.
+        ! All operations targeting the same rank always get
+        ! the same queue, so that sequences of operations to
+        ! a peer stay on a single queue. The queues must be
+        ! retrieved with tagaspi_queue_group_get_queue_for_rank.
+        enumerator :: GASPI_QUEUE_GROUP_POLICY_RANK = 2
     end enum
 
     interface ! tagaspi_proc_init
@@ -169,6 +177,760 @@ module TAGASPI
       end function tagaspi_write_list_notify
     end interface
 
+    interface ! tagaspi_write_detached
+      function tagaspi_write_detached(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue) &
+&         result( res ) bind(C, name="tagaspi_write_detached")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_detached
+    end interface
+
+    interface ! tagaspi_notify_detached
+      function tagaspi_notify_detached(segment_id_remote,rank, &
+&         notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_notify_detached")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_notify_detached
+    end interface
+
+    interface ! tagaspi_write_notify_detached
+      function tagaspi_write_notify_detached(segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size,notification_id, &
+&         notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_write_notify_detached")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_notify_detached
+    end interface
+
+    interface ! tagaspi_fence_async
+      function tagaspi_fence_async(queue) &
+&         result( res ) bind(C, name="tagaspi_fence_async")
+    import
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_fence_async
+    end interface
+
+    interface ! tagaspi_read_notify
+      function tagaspi_read_notify(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,notification_id,queue) &
+&         result( res ) bind(C, name="tagaspi_read_notify")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_read_notify
+    end interface
+
+    interface ! tagaspi_read_list_notify
+      function tagaspi_read_list_notify(num,segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size,segment_id_notification, &
+&         notification_id,queue) &
+&         result( res ) bind(C, name="tagaspi_read_list_notify")
+    import
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: segment_id_local
+    type(c_ptr), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    type(c_ptr), value :: segment_id_remote
+    type(c_ptr), value :: offset_remote
+    type(c_ptr), value :: size
+    integer(gaspi_segment_id_t), value :: segment_id_notification
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_read_list_notify
+    end interface
+
+    interface ! tagaspi_write_request
+      function tagaspi_write_request(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue,request) &
+&         result( res ) bind(C, name="tagaspi_write_request")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    type(c_ptr), intent(out) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_request
+    end interface
+
+    interface ! tagaspi_read_request
+      function tagaspi_read_request(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue,request) &
+&         result( res ) bind(C, name="tagaspi_read_request")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    type(c_ptr), intent(out) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_read_request
+    end interface
+
+    interface ! tagaspi_notify_request
+      function tagaspi_notify_request(segment_id_remote,rank, &
+&         notification_id,notification_value,queue,request) &
+&         result( res ) bind(C, name="tagaspi_notify_request")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    type(c_ptr), intent(out) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_notify_request
+    end interface
+
+    interface ! tagaspi_write_notify_request
+      function tagaspi_write_notify_request(segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size,notification_id, &
+&         notification_value,queue,request) &
+&         result( res ) bind(C, name="tagaspi_write_notify_request")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    type(c_ptr), intent(out) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_notify_request
+    end interface
+
+    interface ! tagaspi_request_test
+      function tagaspi_request_test(request,flag) &
+&         result( res ) bind(C, name="tagaspi_request_test")
+    import
+    type(c_ptr), intent(inout) :: request
+    integer(c_int), intent(out) :: flag
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_test
+    end interface
+
+    interface ! tagaspi_request_wait_async
+      function tagaspi_request_wait_async(request) &
+&         result( res ) bind(C, name="tagaspi_request_wait_async")
+    import
+    type(c_ptr), intent(inout) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_wait_async
+    end interface
+
+    interface ! tagaspi_request_waitall_async
+      function tagaspi_request_waitall_async(num,requests) &
+&         result( res ) bind(C, name="tagaspi_request_waitall_async")
+    import
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: requests
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_waitall_async
+    end interface
+
+    interface ! tagaspi_request_wait_callback
+      function tagaspi_request_wait_callback(request,callback,args,flag) &
+&         result( res ) bind(C, name="tagaspi_request_wait_callback")
+    import
+    type(c_ptr), intent(inout) :: request
+    type(c_funptr), value :: callback
+    type(c_ptr), value :: args
+    integer(c_int), intent(out) :: flag
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_wait_callback
+    end interface
+
+    interface ! tagaspi_notify_wait_callback
+      function tagaspi_notify_wait_callback(segment_id_local, &
+&         notification_id,old_notification_value,callback,args,flag) &
+&         result( res ) bind(C, name="tagaspi_notify_wait_callback")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_notification_id_t), value :: notification_id
+    type(c_ptr), value :: old_notification_value
+    type(c_funptr), value :: callback
+    type(c_ptr), value :: args
+    integer(c_int), intent(out) :: flag
+    integer(gaspi_return_t) :: res
+      end function tagaspi_notify_wait_callback
+    end interface
+
+    interface ! tagaspi_request_create
+      function tagaspi_request_create(request) &
+&         result( res ) bind(C, name="tagaspi_request_create")
+    import
+    type(c_ptr), intent(out) :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_create
+    end interface
+
+    interface ! tagaspi_request_complete
+      function tagaspi_request_complete(request) &
+&         result( res ) bind(C, name="tagaspi_request_complete")
+    import
+    type(c_ptr), value :: request
+    integer(gaspi_return_t) :: res
+      end function tagaspi_request_complete
+    end interface
+
+    interface ! tagaspi_atomic_fetch_add
+      function tagaspi_atomic_fetch_add(segment_id,offset,rank, &
+&         val_add,val_old) &
+&         result( res ) bind(C, name="tagaspi_atomic_fetch_add")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id
+    integer(gaspi_offset_t), value :: offset
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_atomic_value_t), value :: val_add
+    type(c_ptr), value :: val_old
+    integer(gaspi_return_t) :: res
+      end function tagaspi_atomic_fetch_add
+    end interface
+
+    interface ! tagaspi_atomic_compare_swap
+      function tagaspi_atomic_compare_swap(segment_id,offset,rank, &
+&         comparator,val_new,val_old) &
+&         result( res ) bind(C, name="tagaspi_atomic_compare_swap")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id
+    integer(gaspi_offset_t), value :: offset
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_atomic_value_t), value :: comparator
+    integer(gaspi_atomic_value_t), value :: val_new
+    type(c_ptr), value :: val_old
+    integer(gaspi_return_t) :: res
+      end function tagaspi_atomic_compare_swap
+    end interface
+
+    interface ! tagaspi_passive_send_async
+      function tagaspi_passive_send_async(segment_id_local,offset_local, &
+&         rank,size) &
+&         result( res ) bind(C, name="tagaspi_passive_send_async")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_return_t) :: res
+      end function tagaspi_passive_send_async
+    end interface
+
+    interface ! tagaspi_passive_receive_async
+      function tagaspi_passive_receive_async(segment_id_local,offset_local, &
+&         rem_rank,size) &
+&         result( res ) bind(C, name="tagaspi_passive_receive_async")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: rem_rank
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_return_t) :: res
+      end function tagaspi_passive_receive_async
+    end interface
+
+    interface ! tagaspi_write_striped
+      function tagaspi_write_striped(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue_group) &
+&         result( res ) bind(C, name="tagaspi_write_striped")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_striped
+    end interface
+
+    interface ! tagaspi_read_striped
+      function tagaspi_read_striped(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue_group) &
+&         result( res ) bind(C, name="tagaspi_read_striped")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_read_striped
+    end interface
+
+    interface ! tagaspi_write_striped_notify
+      function tagaspi_write_striped_notify(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote, &
+&         size,notification_id,notification_value,queue_group) &
+&         result( res ) bind(C, name="tagaspi_write_striped_notify")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_striped_notify
+    end interface
+
+    interface ! tagaspi_write_notify_multi
+      function tagaspi_write_notify_multi(segment_id_local,offset_local, &
+&         num,ranks,segment_id_remote,offsets_remote,size, &
+&         notification_id,notification_value,queue_group) &
+&         result( res ) bind(C, name="tagaspi_write_notify_multi")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: ranks
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    type(c_ptr), value :: offsets_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_notify_multi
+    end interface
+
+    interface ! tagaspi_write_strided
+      function tagaspi_write_strided(segment_id_local,offset_local,strides_local, &
+&         rank,segment_id_remote,offset_remote,strides_remote, &
+&         dims,counts,queue) &
+&         result( res ) bind(C, name="tagaspi_write_strided")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: strides_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    type(c_ptr), value :: strides_remote
+    integer(gaspi_number_t), value :: dims
+    type(c_ptr), value :: counts
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_strided
+    end interface
+
+    interface ! tagaspi_read_strided
+      function tagaspi_read_strided(segment_id_local,offset_local,strides_local, &
+&         rank,segment_id_remote,offset_remote,strides_remote, &
+&         dims,counts,queue) &
+&         result( res ) bind(C, name="tagaspi_read_strided")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: strides_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    type(c_ptr), value :: strides_remote
+    integer(gaspi_number_t), value :: dims
+    type(c_ptr), value :: counts
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_read_strided
+    end interface
+
+    interface ! tagaspi_write_strided_notify
+      function tagaspi_write_strided_notify(segment_id_local,offset_local,strides_local, &
+&         rank,segment_id_remote,offset_remote,strides_remote, &
+&         dims,counts,notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_write_strided_notify")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: strides_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    type(c_ptr), value :: strides_remote
+    integer(gaspi_number_t), value :: dims
+    type(c_ptr), value :: counts
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_strided_notify
+    end interface
+
+    interface ! tagaspi_write_strided_packed_notify
+      function tagaspi_write_strided_packed_notify(segment_id_local,offset_local, &
+&         strides_local,rank,segment_id_remote,offset_remote,strides_remote, &
+&         dims,counts,segment_id_staging,offset_staging_local, &
+&         offset_staging_remote,notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_write_strided_packed_notify")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: strides_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    type(c_ptr), value :: strides_remote
+    integer(gaspi_number_t), value :: dims
+    type(c_ptr), value :: counts
+    integer(gaspi_segment_id_t), value :: segment_id_staging
+    integer(gaspi_offset_t), value :: offset_staging_local
+    integer(gaspi_offset_t), value :: offset_staging_remote
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_strided_packed_notify
+    end interface
+
+    interface ! tagaspi_unpack_strided_async
+      function tagaspi_unpack_strided_async(segment_id_staging,offset_staging, &
+&         segment_id_local,offset_local,strides_local,dims,counts, &
+&         notification_id,notification_value) &
+&         result( res ) bind(C, name="tagaspi_unpack_strided_async")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_staging
+    integer(gaspi_offset_t), value :: offset_staging
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    type(c_ptr), value :: strides_local
+    integer(gaspi_number_t), value :: dims
+    type(c_ptr), value :: counts
+    integer(gaspi_notification_id_t), value :: notification_id
+    type(c_ptr), value :: notification_value
+    integer(gaspi_return_t) :: res
+      end function tagaspi_unpack_strided_async
+    end interface
+
+    interface ! tagaspi_aggregation_enable
+      function tagaspi_aggregation_enable(segment_id,buffer_size,queue) &
+&         result( res ) bind(C, name="tagaspi_aggregation_enable")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id
+    integer(gaspi_size_t), value :: buffer_size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_aggregation_enable
+    end interface
+
+    interface ! tagaspi_aggregation_disable
+      function tagaspi_aggregation_disable() &
+&         result( res ) bind(C, name="tagaspi_aggregation_disable")
+    import
+    integer(gaspi_return_t) :: res
+      end function tagaspi_aggregation_disable
+    end interface
+
+    interface ! tagaspi_write_notify_aggregated
+      function tagaspi_write_notify_aggregated(segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote, &
+&         size,notification_id,notification_value) &
+&         result( res ) bind(C, name="tagaspi_write_notify_aggregated")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_return_t) :: res
+      end function tagaspi_write_notify_aggregated
+    end interface
+
+    interface ! tagaspi_plan_create
+      function tagaspi_plan_create(plan) &
+&         result( res ) bind(C, name="tagaspi_plan_create")
+    import
+    type(c_ptr), intent(out) :: plan
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_create
+    end interface
+
+    interface ! tagaspi_plan_free
+      function tagaspi_plan_free(plan) &
+&         result( res ) bind(C, name="tagaspi_plan_free")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_free
+    end interface
+
+    interface ! tagaspi_plan_add_write
+      function tagaspi_plan_add_write(plan,segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_write")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_write
+    end interface
+
+    interface ! tagaspi_plan_add_read
+      function tagaspi_plan_add_read(plan,segment_id_local,offset_local,rank, &
+&         segment_id_remote,offset_remote,size,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_read")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_read
+    end interface
+
+    interface ! tagaspi_plan_add_notify
+      function tagaspi_plan_add_notify(plan,segment_id_remote,rank, &
+&         notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_notify")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_notify
+    end interface
+
+    interface ! tagaspi_plan_add_write_notify
+      function tagaspi_plan_add_write_notify(plan,segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size, &
+&         notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_write_notify")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_offset_t), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    integer(gaspi_offset_t), value :: offset_remote
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_write_notify
+    end interface
+
+    interface ! tagaspi_plan_add_write_list
+      function tagaspi_plan_add_write_list(plan,num,segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_write_list")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: segment_id_local
+    type(c_ptr), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    type(c_ptr), value :: segment_id_remote
+    type(c_ptr), value :: offset_remote
+    type(c_ptr), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_write_list
+    end interface
+
+    interface ! tagaspi_plan_add_read_list
+      function tagaspi_plan_add_read_list(plan,num,segment_id_local,offset_local, &
+&         rank,segment_id_remote,offset_remote,size,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_read_list")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: segment_id_local
+    type(c_ptr), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    type(c_ptr), value :: segment_id_remote
+    type(c_ptr), value :: offset_remote
+    type(c_ptr), value :: size
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_read_list
+    end interface
+
+    interface ! tagaspi_plan_add_write_list_notify
+      function tagaspi_plan_add_write_list_notify(plan,num,segment_id_local, &
+&         offset_local,rank,segment_id_remote,offset_remote,size, &
+&         segment_id_notification,notification_id,notification_value,queue) &
+&         result( res ) bind(C, name="tagaspi_plan_add_write_list_notify")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_number_t), value :: num
+    type(c_ptr), value :: segment_id_local
+    type(c_ptr), value :: offset_local
+    integer(gaspi_rank_t), value :: rank
+    type(c_ptr), value :: segment_id_remote
+    type(c_ptr), value :: offset_remote
+    type(c_ptr), value :: size
+    integer(gaspi_segment_id_t), value :: segment_id_notification
+    integer(gaspi_notification_id_t), value :: notification_id
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_add_write_list_notify
+    end interface
+
+    interface ! tagaspi_plan_start
+      function tagaspi_plan_start(plan) &
+&         result( res ) bind(C, name="tagaspi_plan_start")
+    import
+    type(c_ptr), value :: plan
+    integer(gaspi_return_t) :: res
+      end function tagaspi_plan_start
+    end interface
+
+    interface ! tagaspi_collectives_enable
+      function tagaspi_collectives_enable(segment_id,queue) &
+&         result( res ) bind(C, name="tagaspi_collectives_enable")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id
+    integer(gaspi_queue_id_t), value :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_collectives_enable
+    end interface
+
+    interface ! tagaspi_collectives_disable
+      function tagaspi_collectives_disable() &
+&         result( res ) bind(C, name="tagaspi_collectives_disable")
+    import
+    integer(gaspi_return_t) :: res
+      end function tagaspi_collectives_disable
+    end interface
+
+    interface ! tagaspi_barrier_async
+      function tagaspi_barrier_async(group) &
+&         result( res ) bind(C, name="tagaspi_barrier_async")
+    import
+    integer(gaspi_group_t), value :: group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_barrier_async
+    end interface
+
+    interface ! tagaspi_allreduce_async
+      function tagaspi_allreduce_async(buffer_send,buffer_receive,num, &
+&         operation,datatype,group) &
+&         result( res ) bind(C, name="tagaspi_allreduce_async")
+    import
+    type(c_ptr), value :: buffer_send
+    type(c_ptr), value :: buffer_receive
+    integer(gaspi_number_t), value :: num
+    integer(gaspi_operation_t), value :: operation
+    integer(gaspi_datatype_t), value :: datatype
+    integer(gaspi_group_t), value :: group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_allreduce_async
+    end interface
+
+    interface ! tagaspi_bcast_async
+      function tagaspi_bcast_async(buffer,size,root,group) &
+&         result( res ) bind(C, name="tagaspi_bcast_async")
+    import
+    type(c_ptr), value :: buffer
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_rank_t), value :: root
+    integer(gaspi_group_t), value :: group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_bcast_async
+    end interface
+
+    interface ! tagaspi_alltoallv_async
+      function tagaspi_alltoallv_async(segment_id_local,offsets_local, &
+&         sizes,segment_id_remote,offsets_remote,notification_begin, &
+&         notification_value,group) &
+&         result( res ) bind(C, name="tagaspi_alltoallv_async")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    type(c_ptr), value :: offsets_local
+    type(c_ptr), value :: sizes
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    type(c_ptr), value :: offsets_remote
+    integer(gaspi_notification_id_t), value :: notification_begin
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_group_t), value :: group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_alltoallv_async
+    end interface
+
+    interface ! tagaspi_neighbor_exchange_async
+      function tagaspi_neighbor_exchange_async(segment_id_local, &
+&         num_neighbors,neighbors,offsets_local,sizes,segment_id_remote, &
+&         offsets_remote,notification_ids,notification_value,group) &
+&         result( res ) bind(C, name="tagaspi_neighbor_exchange_async")
+    import
+    integer(gaspi_segment_id_t), value :: segment_id_local
+    integer(gaspi_number_t), value :: num_neighbors
+    type(c_ptr), value :: neighbors
+    type(c_ptr), value :: offsets_local
+    type(c_ptr), value :: sizes
+    integer(gaspi_segment_id_t), value :: segment_id_remote
+    type(c_ptr), value :: offsets_remote
+    type(c_ptr), value :: notification_ids
+    integer(gaspi_notification_t), value :: notification_value
+    integer(gaspi_group_t), value :: group
+    integer(gaspi_return_t) :: res
+      end function tagaspi_neighbor_exchange_async
+    end interface
+
     interface ! tagaspi_notify_async_wait
       function tagaspi_notify_async_wait(segment_id_local,notification_id, &
 &         old_notification_value) &
@@ -206,6 +968,34 @@ module TAGASPI
       end function tagaspi_queue_group_create
     end interface
 
+    interface ! tagaspi_queue_group_create_split
+      function tagaspi_queue_group_create_split(queue_group,queue_begin, &
+&         latency_queue_num,bulk_queue_num,size_threshold,policy) &
+&         result( res ) bind(C, name="tagaspi_queue_group_create_split")
+    import
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_queue_id_t), value :: queue_begin
+    integer(gaspi_number_t), value :: latency_queue_num
+    integer(gaspi_number_t), value :: bulk_queue_num
+    integer(gaspi_size_t), value :: size_threshold
+    integer(gaspi_queue_group_policy_t), value :: policy
+    integer(gaspi_return_t) :: res
+      end function tagaspi_queue_group_create_split
+    end interface
+
+    interface ! tagaspi_queue_group_create_elastic
+      function tagaspi_queue_group_create_elastic(queue_group, &
+&         min_queue_num,max_queue_num,policy) &
+&         result( res ) bind(C, name="tagaspi_queue_group_create_elastic")
+    import
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_number_t), value :: min_queue_num
+    integer(gaspi_number_t), value :: max_queue_num
+    integer(gaspi_queue_group_policy_t), value :: policy
+    integer(gaspi_return_t) :: res
+      end function tagaspi_queue_group_create_elastic
+    end interface
+
     interface ! tagaspi_queue_group_delete
       function tagaspi_queue_group_delete(queue_group) &
 &         result( res ) bind(C, name="tagaspi_queue_group_delete")
@@ -225,6 +1015,41 @@ module TAGASPI
       end function tagaspi_queue_group_get_queue
     end interface
 
+    interface ! tagaspi_queue_group_get_queue_for_rank
+      function tagaspi_queue_group_get_queue_for_rank(queue_group,rank,queue) &
+&         result( res ) bind(C, name="tagaspi_queue_group_get_queue_for_rank")
+    import
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_queue_id_t) :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_queue_group_get_queue_for_rank
+    end interface
+
+    interface ! tagaspi_queue_group_get_queue_for_size
+      function tagaspi_queue_group_get_queue_for_size(queue_group,size,queue) &
+&         result( res ) bind(C, name="tagaspi_queue_group_get_queue_for_size")
+    import
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t) :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_queue_group_get_queue_for_size
+    end interface
+
+    interface ! tagaspi_queue_group_get_queue_for_rank_and_size
+      function tagaspi_queue_group_get_queue_for_rank_and_size(queue_group, &
+&         rank,size,queue) &
+&         result( res ) bind(C, name="tagaspi_queue_group_get_queue_for_rank_and_size")
+    import
+    integer(gaspi_queue_group_id_t), value :: queue_group
+    integer(gaspi_rank_t), value :: rank
+    integer(gaspi_size_t), value :: size
+    integer(gaspi_queue_id_t) :: queue
+    integer(gaspi_return_t) :: res
+      end function tagaspi_queue_group_get_queue_for_rank_and_size
+    end interface
+
     interface ! tagaspi_queue_group_max
       function tagaspi_queue_group_max(queue_group_max) &
 &         result( res ) bind(C, name="tagaspi_queue_group_max")
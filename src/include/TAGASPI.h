@@ -19,19 +19,41 @@ extern "C" {
 
 typedef unsigned char gaspi_queue_group_id_t;
 
+/* Opaque handle of a persistent communication plan */
+typedef struct tagaspi_plan *tagaspi_plan_t;
+
+/* Opaque handle of an operation followed through a request */
+typedef struct tagaspi_request *tagaspi_request_t;
+
+#define TAGASPI_REQUEST_NULL (tagaspi_request_t)0
+
+/* Function called from the polling once an awaited event happens */
+typedef void (*tagaspi_callback_t)(void *args);
+
 typedef enum
 {
 	/* Distribution of the queues using round-robin.
-	 * Each call gets a different queue. */
+	 * Consecutive calls from the same CPU get different
+	 * queues. Each CPU starts at a different queue.
+	 * Threads outside tasks rotate through the queues on
+	 * their own, which also applies to the CPU policy. */
 	GASPI_QUEUE_GROUP_POLICY_DEFAULT = 0,
 	/* Distribution of the queues across CPUs using
 	 * round-robin. Each CPU will always get the same
 	 * queue. If the number of CPUs exceeds the number of
 	 * queues, the queues are distributed in a round-robin
 	 * way. This policy avoids assigning the same queue to
-	 * CPUs that are in different NUMA nodes.
+	 * CPUs that do not share the last-level cache, unless
+	 * there are fewer queues than cache domains.
+	 */
+	GASPI_QUEUE_GROUP_POLICY_CPU_RR = 1,
+	/* Distribution of the queues by destination rank.
+	 * All operations targeting the same rank always get
+	 * the same queue, so that sequences of operations to
+	 * a peer stay on a single queue. The queues must be
+	 * retrieved with tagaspi_queue_group_get_queue_for_rank.
 	 */
-	GASPI_QUEUE_GROUP_POLICY_CPU_RR = 1
+	GASPI_QUEUE_GROUP_POLICY_RANK = 2
 } gaspi_queue_group_policy_t;
 
 gaspi_return_t
@@ -109,6 +131,531 @@ tagaspi_write_list_notify(const gaspi_number_t num,
 		const gaspi_notification_t notification_value,
 		const gaspi_queue_id_t queue);
 
+/* Detached operations are not bound to the calling task, so it can
+ * complete before they do. The fence releases the calling task once
+ * all detached operations previously issued on the queue, by any
+ * task, have completed. Detached operations are not subject to the
+ * flow control, and they must be fenced before the termination.
+ */
+gaspi_return_t
+tagaspi_write_detached(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_notify_detached(const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_write_notify_detached(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_fence_async(const gaspi_queue_id_t queue);
+
+/* Unlike gaspi_read_notify, the notification of reads is posted on
+ * the segment of the owner of the data, so that it knows its buffer
+ * can be reused. It is sent with value 1 once the data has been read
+ * into the local segment, and the calling task completes once the
+ * notification has been posted. The notification segment of lists
+ * belongs to the remote rank.
+ */
+gaspi_return_t
+tagaspi_read_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_read_list_notify(const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_segment_id_t segment_id_notification,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_queue_id_t queue);
+
+/* Operations with a request are not bound to the calling task.
+ * Instead, the task follows their completion through the request,
+ * so a long-lived task can keep several transfers in flight and
+ * react to each one. A request must be either tested until it
+ * completes or waited, which binds its completion to the calling
+ * task. Both ways release the request and reset the handle to
+ * TAGASPI_REQUEST_NULL. Operations with a request are not subject
+ * to the flow control, and they never wait for queue space: those
+ * that find their queue full are posted later, in order, from the
+ * polling, so they can be submitted from callbacks.
+ */
+gaspi_return_t
+tagaspi_write_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request);
+
+gaspi_return_t
+tagaspi_read_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request);
+
+gaspi_return_t
+tagaspi_notify_request(const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request);
+
+gaspi_return_t
+tagaspi_write_notify_request(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue,
+		tagaspi_request_t * const request);
+
+/* Set the flag if the operation has completed, without blocking */
+gaspi_return_t
+tagaspi_request_test(tagaspi_request_t * const request, int * const flag);
+
+/* The calling task completes once the operations have completed */
+gaspi_return_t
+tagaspi_request_wait_async(tagaspi_request_t * const request);
+
+gaspi_return_t
+tagaspi_request_waitall_async(const gaspi_number_t num,
+		tagaspi_request_t * const requests);
+
+/* Callbacks are an alternative to binding the completion to a task.
+ * If the awaited event already happened, the flag is set and the
+ * callback is not called. Otherwise, the callback is called once from
+ * the polling, so it must be short and cannot block. The request is
+ * released and reset to TAGASPI_REQUEST_NULL in both cases.
+ */
+gaspi_return_t
+tagaspi_request_wait_callback(tagaspi_request_t * const request,
+		tagaspi_callback_t callback,
+		void *args,
+		int * const flag);
+
+gaspi_return_t
+tagaspi_notify_wait_callback(const gaspi_segment_id_t segment_id_local,
+		const gaspi_notification_id_t notification_id,
+		gaspi_notification_t *old_notification_value,
+		tagaspi_callback_t callback,
+		void *args,
+		int * const flag);
+
+/* Requests not tied to any operation, which complete when the owner
+ * calls tagaspi_request_complete. The request can be waited or tested
+ * as the rest, while the owner keeps a copy of the handle to complete
+ * it later.
+ */
+gaspi_return_t
+tagaspi_request_create(tagaspi_request_t * const request);
+
+gaspi_return_t
+tagaspi_request_complete(tagaspi_request_t request);
+
+/* Remote atomics run asynchronously on behalf of the calling task.
+ * The old value is stored in the given location, which may be null,
+ * before the task completes. Misaligned offsets, invalid segments and
+ * invalid ranks are reported without registering any event.
+ */
+gaspi_return_t
+tagaspi_atomic_fetch_add(const gaspi_segment_id_t segment_id,
+		const gaspi_offset_t offset,
+		const gaspi_rank_t rank,
+		const gaspi_atomic_value_t val_add,
+		gaspi_atomic_value_t * const val_old);
+
+gaspi_return_t
+tagaspi_atomic_compare_swap(const gaspi_segment_id_t segment_id,
+		const gaspi_offset_t offset,
+		const gaspi_rank_t rank,
+		const gaspi_atomic_value_t comparator,
+		const gaspi_atomic_value_t val_new,
+		gaspi_atomic_value_t * const val_old);
+
+/* Passive communication runs asynchronously on behalf of the calling
+ * task. A send completes once its buffer can be reused, and a receive
+ * once the message and the rank of its sender are stored. Receives
+ * are matched with the incoming messages in calling order. The
+ * operations block internal tasks, which take a core while waiting.
+ */
+gaspi_return_t
+tagaspi_passive_send_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_size_t size);
+
+gaspi_return_t
+tagaspi_passive_receive_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		gaspi_rank_t * const rem_rank,
+		const gaspi_size_t size);
+
+/* Striped operations split a large transfer into chunks across
+ * the queues of a queue group. All chunks complete as a single
+ * event of the calling task. The notification of the notify
+ * variant is posted once all chunks have completed.
+ */
+gaspi_return_t
+tagaspi_write_striped(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_group_id_t queue_group);
+
+gaspi_return_t
+tagaspi_read_striped(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_group_id_t queue_group);
+
+gaspi_return_t
+tagaspi_write_striped_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_group_id_t queue_group);
+
+/* Writes the same local buffer with notification to several ranks,
+ * each one at its own remote offset. The writes are spread across
+ * the queues of the group with a single event accounting step, except
+ * with the rank policy, where each write uses the queue of its rank.
+ */
+gaspi_return_t
+tagaspi_write_notify_multi(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_number_t num,
+		const gaspi_rank_t ranks[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_group_id_t queue_group);
+
+/* Strided operations transfer a subarray of several dimensions.
+ * The first count is the size in bytes of the contiguous blocks,
+ * and the count d > 0 is the number of blocks along dimension d.
+ * The stride d-1 of each side is the distance in bytes between
+ * consecutive blocks along dimension d. The generated lists of
+ * descriptors are cached, so repeating a transfer is cheap.
+ */
+gaspi_return_t
+tagaspi_write_strided(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_read_strided(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_write_strided_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+/* Packed transfers gather a strided region into a staging area
+ * and write it with a single request. The receiver must call the
+ * unpack function with the same staging area and its layout. Its
+ * calling task completes once the data has been unpacked into the
+ * region. Regions whose contiguous blocks at the receiver are large
+ * are written directly to their destination instead. In both cases,
+ * the notification is posted on the staging segment.
+ */
+gaspi_return_t
+tagaspi_write_strided_packed_notify(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t strides_remote[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_segment_id_t segment_id_staging,
+		const gaspi_offset_t offset_staging_local,
+		const gaspi_offset_t offset_staging_remote,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_unpack_strided_async(const gaspi_segment_id_t segment_id_staging,
+		const gaspi_offset_t offset_staging,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_size_t strides_local[],
+		const gaspi_number_t dims,
+		const gaspi_size_t counts[],
+		const gaspi_notification_id_t notification_id,
+		gaspi_notification_t *notification_value);
+
+/* Aggregation packs small write-notify operations targeting the
+ * same rank into staging buffers of a dedicated segment, which
+ * are sent once full or after a timeout. The receiver unpacks
+ * each record into its target offset and posts its notification.
+ * Aggregated records do not add events to the calling task, since
+ * their payloads are copied. Records larger than a staging buffer
+ * are written directly, after the previous records to the same
+ * rank, and the calling task waits for them. The records to a rank
+ * are applied in calling order. The enable and disable functions
+ * are collective over all ranks.
+ */
+gaspi_return_t
+tagaspi_aggregation_enable(const gaspi_segment_id_t segment_id,
+		const gaspi_size_t buffer_size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_aggregation_disable(void);
+
+gaspi_return_t
+tagaspi_write_notify_aggregated(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value);
+
+/* Persistent plans record a sequence of operations once, so
+ * that iterative codes can issue the same operations at every
+ * step with low overhead. Starting a plan submits all its
+ * operations on behalf of the calling task, which completes
+ * once all of them have completed. The descriptors of list
+ * operations are copied when they are added to the plan. A
+ * plan can be started several times, even concurrently.
+ */
+gaspi_return_t
+tagaspi_plan_create(tagaspi_plan_t * const plan);
+
+gaspi_return_t
+tagaspi_plan_free(tagaspi_plan_t plan);
+
+gaspi_return_t
+tagaspi_plan_add_write(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_read(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_notify(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_rank_t rank,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_write_notify(tagaspi_plan_t plan,
+		const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offset_local,
+		const gaspi_rank_t rank,
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offset_remote,
+		const gaspi_size_t size,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_write_list(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_read_list(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_add_write_list_notify(tagaspi_plan_t plan,
+		const gaspi_number_t num,
+		gaspi_segment_id_t * const segment_id_local,
+		gaspi_offset_t * const offset_local,
+		const gaspi_rank_t rank,
+		gaspi_segment_id_t * const segment_id_remote,
+		gaspi_offset_t * const offset_remote,
+		gaspi_size_t * const size,
+		const gaspi_segment_id_t segment_id_notification,
+		const gaspi_notification_id_t notification_id,
+		const gaspi_notification_t notification_value,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_plan_start(tagaspi_plan_t plan);
+
+/* Task-aware collectives exchange notifications on a dedicated
+ * segment, which is created on all ranks when enabling them. The
+ * calling task of a collective completes once the collective has
+ * finished on this rank. The collectives of a group must be called
+ * in the same order on all its members, and the group cannot be
+ * deleted while the collectives are enabled. The enable and disable
+ * functions are collective over all ranks.
+ */
+gaspi_return_t
+tagaspi_collectives_enable(const gaspi_segment_id_t segment_id,
+		const gaspi_queue_id_t queue);
+
+gaspi_return_t
+tagaspi_collectives_disable(void);
+
+gaspi_return_t
+tagaspi_barrier_async(const gaspi_group_t group);
+
+/* The allreduce pipelines its data in chunks, so the reduction
+ * of a chunk overlaps the transfers of the next ones. The send
+ * and receive buffers may be the same, and they do not need to
+ * be part of a segment.
+ */
+gaspi_return_t
+tagaspi_allreduce_async(const gaspi_pointer_t buffer_send,
+		gaspi_pointer_t buffer_receive,
+		const gaspi_number_t num,
+		const gaspi_operation_t operation,
+		const gaspi_datatype_t datatype,
+		const gaspi_group_t group);
+
+/* The broadcast pipelines its data in chunks through a tree, where
+ * each rank forwards the chunks to its children as they arrive. The
+ * root is a rank of the group, otherwise GASPI_ERR_INV_RANK is
+ * returned, and all members must pass the same size. The buffer
+ * does not need to be part of a segment.
+ */
+gaspi_return_t
+tagaspi_bcast_async(gaspi_pointer_t buffer,
+		const gaspi_size_t size,
+		const gaspi_rank_t root,
+		const gaspi_group_t group);
+
+/* The exchanges write a block of the local segment to each peer,
+ * which lands on the remote segment and posts a notification once
+ * complete. Thus, consumer tasks can wait for each block separately.
+ * The calling task completes once all its local writes have completed.
+ * In the alltoallv, the arrays are indexed by the group members, and
+ * the block of the member m posts the notification begin + m. In the
+ * neighbor exchange, each rank passes its own list of neighbors, and
+ * all members of the group must call it.
+ */
+gaspi_return_t
+tagaspi_alltoallv_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_offset_t offsets_local[],
+		const gaspi_size_t sizes[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_notification_id_t notification_begin,
+		const gaspi_notification_t notification_value,
+		const gaspi_group_t group);
+
+gaspi_return_t
+tagaspi_neighbor_exchange_async(const gaspi_segment_id_t segment_id_local,
+		const gaspi_number_t num_neighbors,
+		const gaspi_rank_t neighbors[],
+		const gaspi_offset_t offsets_local[],
+		const gaspi_size_t sizes[],
+		const gaspi_segment_id_t segment_id_remote,
+		const gaspi_offset_t offsets_remote[],
+		const gaspi_notification_id_t notification_ids[],
+		const gaspi_notification_t notification_value,
+		const gaspi_group_t group);
+
 gaspi_return_t
 tagaspi_notify_async_wait(const gaspi_segment_id_t segment_id_local,
 		const gaspi_notification_id_t notification_id,
@@ -126,6 +673,34 @@ tagaspi_queue_group_create(const gaspi_queue_group_id_t queue_group,
 		const gaspi_number_t queue_num,
 		const gaspi_queue_group_policy_t policy);
 
+/* Creates a queue group split into a low-latency subgroup
+ * and a bulk subgroup. The operations smaller than the size
+ * threshold are served by the first latency_queue_num queues,
+ * while the rest are served by the following bulk_queue_num
+ * queues. The policy applies inside each subgroup.
+ */
+gaspi_return_t
+tagaspi_queue_group_create_split(const gaspi_queue_group_id_t queue_group,
+		const gaspi_queue_id_t queue_begin,
+		const gaspi_number_t latency_queue_num,
+		const gaspi_number_t bulk_queue_num,
+		const gaspi_size_t size_threshold,
+		const gaspi_queue_group_policy_t policy);
+
+/* Creates a queue group whose queues are created by TAGASPI.
+ * The group starts with min_queue_num queues and grows up to
+ * max_queue_num queues while the occupancy of its queues stays
+ * high. The last queues are retired when the occupancy stays
+ * low, and they are reused when the group grows again. The
+ * queues are deleted with the group. Only the default policy
+ * is supported.
+ */
+gaspi_return_t
+tagaspi_queue_group_create_elastic(const gaspi_queue_group_id_t queue_group,
+		const gaspi_number_t min_queue_num,
+		const gaspi_number_t max_queue_num,
+		const gaspi_queue_group_policy_t policy);
+
 gaspi_return_t
 tagaspi_queue_group_delete(const gaspi_queue_group_id_t queue_group);
 
@@ -133,6 +708,26 @@ gaspi_return_t
 tagaspi_queue_group_get_queue(const gaspi_queue_group_id_t queue_group,
 		gaspi_queue_id_t * const queue);
 
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_rank(const gaspi_queue_group_id_t queue_group,
+		const gaspi_rank_t rank,
+		gaspi_queue_id_t * const queue);
+
+/* Get the queue for an operation of a given size, which comes
+ * from the bulk subgroup of split groups if the size reaches the
+ * threshold. Groups with the rank policy require the rank too.
+ */
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_size(const gaspi_queue_group_id_t queue_group,
+		const gaspi_size_t size,
+		gaspi_queue_id_t * const queue);
+
+gaspi_return_t
+tagaspi_queue_group_get_queue_for_rank_and_size(const gaspi_queue_group_id_t queue_group,
+		const gaspi_rank_t rank,
+		const gaspi_size_t size,
+		gaspi_queue_id_t * const queue);
+
 gaspi_return_t
 tagaspi_queue_group_max(gaspi_number_t * const queue_group_max);
 
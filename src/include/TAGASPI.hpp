@@ -0,0 +1,265 @@
+/*
+	This file is part of Task-Aware GASPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2023 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef TAGASPI_HPP
+#define TAGASPI_HPP
+
+#include <GASPI.h>
+#include <TAGASPI.h>
+
+#if __cplusplus >= 202002L
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+//! Header-only layer over the request and callback interface that lets
+//! C++20 coroutines await communication. An awaited operation suspends
+//! the coroutine, which is resumed directly from the polling once the
+//! operation completes, without creating any task. Thus, the code after
+//! an awaited operation runs from the polling, so it should be short and
+//! cannot block; longer computations belong to regular tasks. Awaited
+//! operations never wait for queue space, so they can be submitted from
+//! there even if their queue is full
+//!
+//! A coroutine returning tagaspi::Coroutine starts right away in the
+//! calling task, which cannot complete until the coroutine finishes
+namespace tagaspi {
+
+namespace detail {
+
+//! \brief Resume a coroutine from the polling
+inline void resume(void *args)
+{
+	std::coroutine_handle<>::from_address(args).resume();
+}
+
+} // namespace detail
+
+//! Coroutine bound to the task that calls it. The coroutine is started
+//! eagerly and releases itself when it finishes
+class Coroutine {
+public:
+	class promise_type {
+	private:
+		//! The request that keeps the calling task from completing
+		tagaspi_request_t _request;
+
+	public:
+		inline promise_type() :
+			_request(TAGASPI_REQUEST_NULL)
+		{
+			tagaspi_request_t request;
+			gaspi_return_t eret = tagaspi_request_create(&request);
+			assert(eret == GASPI_SUCCESS);
+			(void) eret;
+
+			// Waiting resets the handle, so keep a copy to complete it
+			_request = request;
+			tagaspi_request_wait_async(&request);
+		}
+
+		inline ~promise_type()
+		{
+			tagaspi_request_complete(_request);
+		}
+
+		inline Coroutine get_return_object() noexcept
+		{
+			return Coroutine();
+		}
+
+		inline std::suspend_never initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		inline std::suspend_never final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		inline void return_void() const noexcept
+		{
+		}
+
+		inline void unhandled_exception() const noexcept
+		{
+			std::terminate();
+		}
+	};
+};
+
+//! Awaitable operation followed through a request. The operation is
+//! submitted when awaited, and the awaiting returns its result
+template <typename Submit>
+class OperationAwaitable {
+private:
+	Submit _submit;
+	gaspi_return_t _eret;
+
+public:
+	inline explicit OperationAwaitable(Submit submit) :
+		_submit(std::move(submit)),
+		_eret(GASPI_SUCCESS)
+	{
+	}
+
+	inline bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	inline bool await_suspend(std::coroutine_handle<> handle) noexcept
+	{
+		tagaspi_request_t request;
+		_eret = _submit(&request);
+		if (_eret != GASPI_SUCCESS)
+			return false;
+
+		// The coroutine may be resumed before returning, so the awaitable
+		// cannot be accessed after registering the callback
+		int completed;
+		gaspi_return_t eret = tagaspi_request_wait_callback(&request,
+				detail::resume, handle.address(), &completed);
+		assert(eret == GASPI_SUCCESS);
+		(void) eret;
+
+		return !completed;
+	}
+
+	inline gaspi_return_t await_resume() const noexcept
+	{
+		return _eret;
+	}
+};
+
+//! Awaitable notification. The notification is reset once it arrives,
+//! and its old value is stored in the given location, which may be null
+class NotificationAwaitable {
+private:
+	gaspi_segment_id_t _segment;
+	gaspi_notification_id_t _id;
+	gaspi_notification_t *_value;
+	gaspi_return_t _eret;
+
+public:
+	inline NotificationAwaitable(
+		gaspi_segment_id_t segment,
+		gaspi_notification_id_t id,
+		gaspi_notification_t *value
+	) :
+		_segment(segment),
+		_id(id),
+		_value(value),
+		_eret(GASPI_SUCCESS)
+	{
+	}
+
+	inline bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	inline bool await_suspend(std::coroutine_handle<> handle) noexcept
+	{
+		int notified;
+		gaspi_return_t eret = tagaspi_notify_wait_callback(_segment, _id,
+				_value, detail::resume, handle.address(), &notified);
+
+		// Nothing was registered on failure, so the awaitable is still valid
+		if (eret != GASPI_SUCCESS) {
+			_eret = eret;
+			return false;
+		}
+		return !notified;
+	}
+
+	inline gaspi_return_t await_resume() const noexcept
+	{
+		return _eret;
+	}
+};
+
+inline auto write(
+	gaspi_segment_id_t segment_id_local,
+	gaspi_offset_t offset_local,
+	gaspi_rank_t rank,
+	gaspi_segment_id_t segment_id_remote,
+	gaspi_offset_t offset_remote,
+	gaspi_size_t size,
+	gaspi_queue_id_t queue
+) {
+	return OperationAwaitable(
+		[=](tagaspi_request_t *request) {
+			return tagaspi_write_request(segment_id_local, offset_local, rank,
+				segment_id_remote, offset_remote, size, queue, request);
+		});
+}
+
+inline auto read(
+	gaspi_segment_id_t segment_id_local,
+	gaspi_offset_t offset_local,
+	gaspi_rank_t rank,
+	gaspi_segment_id_t segment_id_remote,
+	gaspi_offset_t offset_remote,
+	gaspi_size_t size,
+	gaspi_queue_id_t queue
+) {
+	return OperationAwaitable(
+		[=](tagaspi_request_t *request) {
+			return tagaspi_read_request(segment_id_local, offset_local, rank,
+				segment_id_remote, offset_remote, size, queue, request);
+		});
+}
+
+inline auto notify(
+	gaspi_segment_id_t segment_id_remote,
+	gaspi_rank_t rank,
+	gaspi_notification_id_t notification_id,
+	gaspi_notification_t notification_value,
+	gaspi_queue_id_t queue
+) {
+	return OperationAwaitable(
+		[=](tagaspi_request_t *request) {
+			return tagaspi_notify_request(segment_id_remote, rank,
+				notification_id, notification_value, queue, request);
+		});
+}
+
+inline auto write_notify(
+	gaspi_segment_id_t segment_id_local,
+	gaspi_offset_t offset_local,
+	gaspi_rank_t rank,
+	gaspi_segment_id_t segment_id_remote,
+	gaspi_offset_t offset_remote,
+	gaspi_size_t size,
+	gaspi_notification_id_t notification_id,
+	gaspi_notification_t notification_value,
+	gaspi_queue_id_t queue
+) {
+	return OperationAwaitable(
+		[=](tagaspi_request_t *request) {
+			return tagaspi_write_notify_request(segment_id_local, offset_local, rank,
+				segment_id_remote, offset_remote, size,
+				notification_id, notification_value, queue, request);
+		});
+}
+
+inline NotificationAwaitable notify_wait(
+	gaspi_segment_id_t segment_id_local,
+	gaspi_notification_id_t notification_id,
+	gaspi_notification_t *old_notification_value = GASPI_NOTIFICATION_IGNORE
+) {
+	return NotificationAwaitable(segment_id_local, notification_id, old_notification_value);
+}
+
+} // namespace tagaspi
+
+#endif // __cplusplus >= 202002L
+
+#endif // TAGASPI_HPP